@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cmath>
+#include <vector>
+
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 #include <SFML/System/Vector2.hpp>
 
 #include "FlexibleClock.hpp"
+#include "SpriteBatch.hpp"
 
 namespace sfext
 {
@@ -18,15 +23,42 @@ namespace sfext
 		sf::Vector2u       rowsAndColumns;
 		oak::FlexibleClock timer;
 		float              fps;
+		std::vector<sf::IntRect>   frameRects; // One per frame, rebuilt whenever the frame layout changes
+		std::vector<sf::FloatRect> frameUVs;   // frameRects normalised to the sprite sheet's texture size
+		sf::Vector2u               uvTextureSize; // Texture size frameUVs were built for
+		void buildFrameTables()
+		{
+			std::size_t count = getFrameCount();
+			frameRects.resize(count);
+			frameUVs.resize(count);
+			uvTextureSize = getTexture() ? getTexture()->getSize() : sf::Vector2u();
+			sf::Vector2f textureSize(static_cast<float>(uvTextureSize.x), static_cast<float>(uvTextureSize.y));
+			for (std::size_t frame = 0; frame < count; ++frame)
+			{
+				std::size_t x = frame % rowsAndColumns.x;
+				std::size_t y = (frame - x) / rowsAndColumns.x;
+				frameRects[frame] = sf::IntRect(static_cast<int>(start.x + x * dimensions.x + x * offset.x), static_cast<int>(start.y + y * dimensions.y + y * offset.y), static_cast<int>(dimensions.x), static_cast<int>(dimensions.y));
+				if (textureSize.x > 0.f && textureSize.y > 0.f)
+				{
+					frameUVs[frame] = sf::FloatRect(frameRects[frame].left / textureSize.x, frameRects[frame].top / textureSize.y, frameRects[frame].width / textureSize.x, frameRects[frame].height / textureSize.y);
+				}
+				else
+				{
+					frameUVs[frame] = sf::FloatRect();
+				}
+			}
+		}
 	public:
 		// Constructors
 		Animation() : start(0.f, 0.f), dimensions(0.f, 0.f), offset(0.f, 0.f), rowsAndColumns(1, 1), fps(24.f)
 		{
+			buildFrameTables();
 		}
 		Animation(const sf::Sprite & sheet, const sf::Vector2f & startPos, const sf::Vector2f & dim, const sf::Vector2f & off, const sf::Vector2u & rowsAndCols, float frameRate = 24.f) : spriteSheet(sheet), start(startPos), dimensions(dim), offset(off), rowsAndColumns(rowsAndCols), fps(frameRate)
 		{
+			buildFrameTables();
 		}
-		Animation(const Animation & rhs) : spriteSheet(rhs.spriteSheet), start(rhs.start), dimensions(rhs.dimensions), offset(rhs.offset), rowsAndColumns(rhs.rowsAndColumns), timer(rhs.timer), fps(rhs.fps)
+		Animation(const Animation & rhs) : spriteSheet(rhs.spriteSheet), start(rhs.start), dimensions(rhs.dimensions), offset(rhs.offset), rowsAndColumns(rhs.rowsAndColumns), timer(rhs.timer), fps(rhs.fps), frameRects(rhs.frameRects), frameUVs(rhs.frameUVs), uvTextureSize(rhs.uvTextureSize)
 		{
 		}
 		// Destructor
@@ -70,15 +102,28 @@ namespace sfext
 		{
 			return rowsAndColumns.x * rowsAndColumns.y;
 		}
+		const std::vector<sf::IntRect> &   getFrameRects() const
+		{
+			// Indexed by frame; batch paths can gather from this directly
+			return frameRects;
+		}
+		const std::vector<sf::FloatRect> & getFrameUVs  () const
+		{
+			// Texture coordinates in [0, 1], empty rectangles if the sprite sheet has no texture; call setTexture after the texture
+			// was reloaded at another size, so they follow it
+			return frameUVs;
+		}
 		// Mutators
 		void setStart         (const sf::Vector2f & pos)
 		{
 			start = pos;
+			buildFrameTables();
 		}
 		void setStart         (float x, float y)
 		{
 			start.x = x;
 			start.y = y;
+			buildFrameTables();
 		}
 		void setFPS           (float newFPS)
 		{
@@ -95,33 +140,50 @@ namespace sfext
 		void setDimensions    (const sf::Vector2f & dim)
 		{
 			dimensions = dim;
+			buildFrameTables();
 		}
 		void setDimensions    (float x, float y)
 		{
 			dimensions.x = x;
 			dimensions.y = y;
+			buildFrameTables();
 		}
 		void setOffset        (const sf::Vector2f & off)
 		{
 			offset = off;
+			buildFrameTables();
 		}
 		void setOffset        (float x, float y)
 		{
 			offset.x = x;
 			offset.y = y;
+			buildFrameTables();
 		}
 		void setRowsAndColumns(const sf::Vector2u & rac)
 		{
 			rowsAndColumns = rac;
+			buildFrameTables();
 		}
 		void setRowsAndColumns(std::size_t x, std::size_t y)
 		{
 			rowsAndColumns.x = x;
 			rowsAndColumns.y = y;
+			buildFrameTables();
 		}
 		void setSpriteSheet   (const sf::Sprite & sprite)
 		{
 			spriteSheet = sprite;
+			buildFrameTables();
+		}
+		void setTexture       (const sf::Texture & texture)
+		{
+			// Keeps the sprite sheet's transform and colour; the UV table is only rebuilt if the texture or its size changed,
+			// so this is cheap enough to call before every use of a texture that may have been evicted and reloaded
+			if (getTexture() != &texture || uvTextureSize != texture.getSize())
+			{
+				spriteSheet.setTexture(texture);
+				buildFrameTables();
+			}
 		}
 		void setRotation      (float angle)
 		{
@@ -138,67 +200,76 @@ namespace sfext
 		}
 		std::size_t currentFrame      (const sf::Time & time) const
 		{
-			return static_cast<std::size_t>((time.asSeconds() * fps)) % getFrameCount();
+			// Wrapped with a floored modulo before the cast, so negative times (a timeline running backwards) count back from the last frame
+			double count = static_cast<double>(getFrameCount());
+			double frame = std::floor(static_cast<double>(time.asSeconds()) * fps);
+			return static_cast<std::size_t>(frame - std::floor(frame / count) * count) % getFrameCount();
 		}
 		sf::IntRect currentTextureRect() const
 		{
-			std::size_t frame = currentFrame();
-			std::size_t x = frame % rowsAndColumns.x;
-			std::size_t y = (frame - x) / rowsAndColumns.x;
-			return sf::IntRect(static_cast<int>(start.x + x * dimensions.x + x * offset.x), static_cast<int>(start.y + y * dimensions.y + y * offset.y), static_cast<int>(dimensions.x), static_cast<int>(dimensions.y));
+			return frameRects[currentFrame()];
 		}
 		sf::IntRect currentTextureRect(const sf::Time & time) const
 		{
-			std::size_t frame = currentFrame(time);
-			std::size_t x = frame % rowsAndColumns.x;
-			std::size_t y = (frame - x) / rowsAndColumns.x;
-			return sf::IntRect(static_cast<int>(start.x + x * dimensions.x + x * offset.x), static_cast<int>(start.y + y * dimensions.y + y * offset.y), static_cast<int>(dimensions.x), static_cast<int>(dimensions.y));
+			return frameRects[currentFrame(time)];
 		}
 		sf::IntRect currentTextureRect(std::size_t frame) const
 		{
-			frame %= getFrameCount();
-			std::size_t x = frame % rowsAndColumns.x;
-			std::size_t y = (frame - x) / rowsAndColumns.x;
-			return sf::IntRect(static_cast<int>(start.x + x * dimensions.x + x * offset.x), static_cast<int>(start.y + y * dimensions.y + y * offset.y), static_cast<int>(dimensions.x), static_cast<int>(dimensions.y));
+			return frameRects[frame % frameRects.size()];
+		}
+		void        writeQuad         (sf::Vertex * quad) const
+		{
+			// Writes the four transformed, tinted vertices of the current frame so callers can gather many animations into one draw
+			writeQuad(quad, currentTextureRect(), spriteSheet.getTransform());
+		}
+		void        writeQuad         (sf::Vertex * quad, std::size_t frame) const
+		{
+			writeQuad(quad, currentTextureRect(frame), spriteSheet.getTransform());
+		}
+		void        writeQuad         (sf::Vertex * quad, const sf::Time & time) const
+		{
+			writeQuad(quad, currentTextureRect(time), spriteSheet.getTransform());
+		}
+		void        writeQuad         (sf::Vertex * quad, const sf::Vector2f & position) const
+		{
+			writeQuad(quad, currentTextureRect(), SpriteBatch::getTransformAt(spriteSheet, position));
+		}
+		void        writeQuad         (sf::Vertex * quad, const sf::Vector2f & position, const sf::Time & time) const
+		{
+			writeQuad(quad, currentTextureRect(time), SpriteBatch::getTransformAt(spriteSheet, position));
+		}
+		void        writeQuad         (sf::Vertex * quad, const sf::Vector2f & position, std::size_t frame) const
+		{
+			writeQuad(quad, currentTextureRect(frame), SpriteBatch::getTransformAt(spriteSheet, position));
+		}
+		void        writeQuad         (sf::Vertex * quad, const sf::IntRect & rectangle, const sf::Transform & transform) const
+		{
+			SpriteBatch::writeQuad(quad, transform, rectangle);
+			quad[0].color = quad[1].color = quad[2].color = quad[3].color = spriteSheet.getColor();
 		}
 		void        draw              (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setTextureRect(currentTextureRect());
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(), spriteSheet.getColor(), spriteSheet.getTransform(), states);
 		}
 		void        draw              (sf::RenderTarget & target, std::size_t frame, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setTextureRect(currentTextureRect(frame));
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(frame), spriteSheet.getColor(), spriteSheet.getTransform(), states);
 		}
 		void        draw              (sf::RenderTarget & target, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setTextureRect(currentTextureRect(time));
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(time), spriteSheet.getColor(), spriteSheet.getTransform(), states);
 		}
 		void        draw              (sf::RenderTarget & target, const sf::Vector2f & position, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setPosition(position);
-			sprite.setTextureRect(currentTextureRect());
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(), spriteSheet.getColor(), SpriteBatch::getTransformAt(spriteSheet, position), states);
 		}
 		void        draw              (sf::RenderTarget & target, const sf::Vector2f & position, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setPosition(position);
-			sprite.setTextureRect(currentTextureRect(time));
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(time), spriteSheet.getColor(), SpriteBatch::getTransformAt(spriteSheet, position), states);
 		}
 		void        draw              (sf::RenderTarget & target, const sf::Vector2f & position, std::size_t frame, sf::RenderStates states = sf::RenderStates::Default) const
 		{
-			sf::Sprite sprite(spriteSheet);
-			sprite.setPosition(position);
-			sprite.setTextureRect(currentTextureRect(frame));
-			target.draw(sprite, states);
+			SpriteBatch::drawQuad(target, getTexture(), currentTextureRect(frame), spriteSheet.getColor(), SpriteBatch::getTransformAt(spriteSheet, position), states);
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <map>
+#include <list>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <sstream>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Time.hpp>
+
+namespace sfext
+{
+	enum class LoopMode
+	{
+		ONCE, // Stop on the last frame
+		LOOP, // Start over from the first frame
+		PINGPONG // Play backwards to the first frame, then forwards again
+	};
+
+	class AnimationClip final
+	{
+	private:
+		std::vector<sf::IntRect> frames;
+		std::vector<float>       endTimes; // Cumulative: frame i is shown while the clip time is below endTimes[i]
+		LoopMode                 loopMode;
+	public:
+		// Constructors
+		AnimationClip() : loopMode(LoopMode::LOOP)
+		{
+		}
+		AnimationClip(const std::vector<sf::IntRect> & rectangles, const std::vector<sf::Time> & durations, LoopMode mode = LoopMode::LOOP) : loopMode(mode)
+		{
+			assert(("Every frame needs a duration", rectangles.size() == durations.size()));
+			for (std::size_t i = 0; i < rectangles.size(); ++i)
+			{
+				addFrame(rectangles[i], durations[i]);
+			}
+		}
+		AnimationClip(const AnimationClip & rhs) : frames(rhs.frames), endTimes(rhs.endTimes), loopMode(rhs.loopMode)
+		{
+		}
+		// Destructor
+		~AnimationClip()
+		{
+		}
+		// Accessors
+		std::size_t                      getFrameCount() const
+		{
+			return frames.size();
+		}
+		const std::vector<sf::IntRect> & getFrames    () const
+		{
+			return frames;
+		}
+		const sf::IntRect &              getFrame     (std::size_t frame) const
+		{
+			assert(("The frame requested does not exist", frame < frames.size()));
+			return frames[frame];
+		}
+		sf::Time                         getDuration  () const
+		{
+			return sf::seconds(endTimes.empty() ? 0.f : endTimes.back());
+		}
+		sf::Time                         getDuration  (std::size_t frame) const
+		{
+			assert(("The frame requested does not exist", frame < frames.size()));
+			return sf::seconds(endTimes[frame] - (frame ? endTimes[frame - 1] : 0.f));
+		}
+		LoopMode                         getLoopMode  () const
+		{
+			return loopMode;
+		}
+		// Mutators
+		void setLoopMode(LoopMode mode)
+		{
+			loopMode = mode;
+		}
+		// Utilities
+		void                addFrame(const sf::IntRect & rectangle, const sf::Time & duration)
+		{
+			frames.push_back(rectangle);
+			endTimes.push_back((endTimes.empty() ? 0.f : endTimes.back()) + std::max(0.f, duration.asSeconds()));
+		}
+		void                clear   ()
+		{
+			frames.clear();
+			endTimes.clear();
+		}
+		std::size_t         frameAt (const sf::Time & time) const
+		{
+			// Folds 'time' into one pass over the clip according to the loop mode, then binary searches the cumulative durations
+			// Like Animation::currentFrame, looping clips wrap negative times with a floored modulo; ONCE shows the first frame before it starts
+			assert(("The clip has no frames", !frames.empty()));
+			float duration = endTimes.back();
+			float seconds = time.asSeconds();
+			if (duration <= 0.f)
+			{
+				return 0;
+			}
+			switch (loopMode)
+			{
+			case LoopMode::ONCE:
+				{
+					if (seconds >= duration)
+					{
+						return frames.size() - 1;
+					}
+					seconds = std::max(0.f, seconds);
+					break;
+				}
+			case LoopMode::LOOP:
+				{
+					seconds -= std::floor(seconds / duration) * duration;
+					break;
+				}
+			case LoopMode::PINGPONG:
+				{
+					seconds -= std::floor(seconds / (2.f * duration)) * 2.f * duration;
+					if (seconds >= duration)
+					{
+						seconds = 2.f * duration - seconds;
+					}
+					break;
+				}
+			}
+			std::size_t frame = std::upper_bound(endTimes.cbegin(), endTimes.cend(), seconds) - endTimes.cbegin();
+			return std::min(frame, frames.size() - 1);
+		}
+		const sf::IntRect & rectAt  (const sf::Time & time) const
+		{
+			return frames[frameAt(time)];
+		}
+	};
+
+	inline std::ostream & operator << (std::ostream & ostr, LoopMode rhs)
+	{
+		switch (rhs)
+		{
+		case LoopMode::ONCE:
+			{
+				ostr << "ONCE";
+				break;
+			}
+		case LoopMode::LOOP:
+			{
+				ostr << "LOOP";
+				break;
+			}
+		case LoopMode::PINGPONG:
+			{
+				ostr << "PINGPONG";
+				break;
+			}
+		}
+		return ostr;
+	}
+
+	inline std::istream & operator >> (std::istream & istr, LoopMode & rhs)
+	{
+		// Sets failbit and leaves 'rhs' untouched for anything but a mode name or number
+		std::string input;
+		istr >> input;
+		for (char & character : input)
+		{
+			character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+		}
+		if (input == "once" || input == "0")
+		{
+			rhs = LoopMode::ONCE;
+		}
+		else if (input == "loop" || input == "1")
+		{
+			rhs = LoopMode::LOOP;
+		}
+		else if (input == "pingpong" || input == "2")
+		{
+			rhs = LoopMode::PINGPONG;
+		}
+		else
+		{
+			istr.setstate(std::ios::failbit);
+		}
+		return istr;
+	}
+
+	// Named clips; copies share the clips themselves, which are never modified once added
+	class ClipSet final
+	{
+	private:
+		std::map<sf::String, std::shared_ptr<const AnimationClip>> clips;
+		// Parsing helpers
+		static bool parseNumbers(const std::list<std::string> & strings, std::vector<double> & result)
+		{
+			// Unlike SML::interpretAsList, rejects anything but a whole number in each element instead of reading it as 0
+			result.clear();
+			for (const std::string & str : strings)
+			{
+				const char * begin = str.c_str();
+				char * end = nullptr;
+				double value = std::strtod(begin, &end);
+				while (*end && std::isspace(static_cast<unsigned char>(*end)))
+				{
+					++end;
+				}
+				if (end == begin || *end || !std::isfinite(value))
+				{
+					return false;
+				}
+				result.push_back(value);
+			}
+			return true;
+		}
+	public:
+		// Constructors
+		ClipSet()
+		{
+		}
+		ClipSet(const ClipSet & rhs) : clips(rhs.clips)
+		{
+		}
+		// Destructor
+		~ClipSet()
+		{
+		}
+		// Accessors
+		std::shared_ptr<const AnimationClip> getClip (const sf::String & name) const
+		{
+			// Returns nullptr for unknown names
+			auto clip = clips.find(name);
+			return clip != clips.cend() ? clip->second : nullptr;
+		}
+		std::size_t                          getSize () const
+		{
+			return clips.size();
+		}
+		// Utilities
+		void addClip    (const sf::String & name, const AnimationClip & clip)
+		{
+			clips[name] = std::make_shared<const AnimationClip>(clip);
+		}
+		bool hasClip    (const sf::String & name) const
+		{
+			return clips.find(name) != clips.cend();
+		}
+		bool removeClip (const sf::String & name)
+		{
+			return clips.erase(name) != 0;
+		}
+		void clear      ()
+		{
+			clips.clear();
+		}
+		template <class Document>
+		bool loadFromSML(const Document & sml, std::vector<std::string> * errors = nullptr)
+		{
+			// Takes an ash::SML; a template so this header, and the handlers including it, do not pull in SML.hpp
+			// Every variable with a 'rects' tag is a clip:
+			//     rects: x, y, width, height, x, y, width, height, ...
+			//     durations: seconds per frame, or a single value for every frame
+			//     loop: once, loop or pingpong (loop if absent)
+			// Returns false if any clip was rejected; the valid ones are still added
+			bool valid = true;
+			auto report = [&valid, errors](const std::string & message)
+			{
+				valid = false;
+				if (errors)
+				{
+					errors->push_back(message);
+				}
+			};
+			for (const sf::String & name : sml.getValueNames())
+			{
+				if (!sml.hasTag(name, "rects"))
+				{
+					continue;
+				}
+				std::vector<double> rectangles;
+				std::vector<double> durations;
+				if (!parseNumbers(sml.interpretAsList(name, "rects"), rectangles) || std::any_of(rectangles.cbegin(), rectangles.cend(), [](double value)
+				{
+					return value != std::floor(value) || std::fabs(value) > 2147483647.0;
+				}))
+				{
+					report(name.toAnsiString() + ": 'rects' must hold integers only, got \"" + sml.getValue(name, "rects").toAnsiString() + "\"");
+					continue;
+				}
+				if (!parseNumbers(sml.interpretAsList(name, "durations"), durations) || std::any_of(durations.cbegin(), durations.cend(), [](double value)
+				{
+					return value <= 0.0;
+				}))
+				{
+					report(name.toAnsiString() + ": 'durations' must hold positive numbers of seconds only, got \"" + sml.getValue(name, "durations").toAnsiString() + "\"");
+					continue;
+				}
+				std::size_t frameCount = rectangles.size() / 4;
+				if (rectangles.size() % 4 != 0 || frameCount == 0 || (durations.size() != 1 && durations.size() != frameCount))
+				{
+					report(name.toAnsiString() + ": expected 4 numbers per frame in 'rects' and one duration, or one per frame, in 'durations'");
+					continue;
+				}
+				AnimationClip clip;
+				if (sml.hasTag(name, "loop"))
+				{
+					std::istringstream loop(sml.getValue(name, "loop").toAnsiString());
+					LoopMode mode;
+					if (!(loop >> mode))
+					{
+						report(name.toAnsiString() + ": unknown loop mode '" + loop.str() + "', expected once, loop or pingpong");
+						continue;
+					}
+					clip.setLoopMode(mode);
+				}
+				auto rectangle = rectangles.cbegin();
+				auto duration = durations.cbegin();
+				for (std::size_t frame = 0; frame < frameCount; ++frame)
+				{
+					int left = static_cast<int>(*rectangle++);
+					int top = static_cast<int>(*rectangle++);
+					int width = static_cast<int>(*rectangle++);
+					int height = static_cast<int>(*rectangle++);
+					clip.addFrame(sf::IntRect(left, top, width, height), sf::seconds(static_cast<float>(*duration)));
+					if (durations.size() != 1)
+					{
+						++duration;
+					}
+				}
+				addClip(name, clip);
+			}
+			return valid;
+		}
+	};
+}
\ No newline at end of file
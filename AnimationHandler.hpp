@@ -2,14 +2,20 @@
 
 #include <cassert>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 
 #include <SFML/System/String.hpp>
+#include <SFML/System/Time.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
 
 #include "SpriteHandler.hpp"
 #include "Animation.hpp"
+#include "AnimationClip.hpp"
 
 namespace sfext
 {
@@ -23,13 +29,101 @@ namespace sfext
 	private:
 		SpriteHandler sprites;
 		std::map<sf::String, Animation> animations;
+		struct QueuedQuads
+		{
+			std::vector<sf::Vertex>        vertices;
+			std::vector<const Animation *> owners; // One per quad, so removing an animation drops only its own quads
+		};
+		std::map<const sf::Texture *, QueuedQuads> queued; // Cleared on flush, keeping capacity for the next frame
+		// Timeline, one slot per animation stored as parallel arrays so update() is a single pass over plain floats
+		std::map<sf::String, std::size_t> timelineSlots;
+		std::vector<sf::String>           timelineAliases;
+		std::vector<float>                timelineSeconds;
+		std::vector<std::uint32_t>        timelineGroups;
+		std::vector<float>                groupScales;
+		std::vector<float>                groupSteps;
+		float                             timeScale;
+		bool                              timelineActive; // Set by the first update(); from then on time-less draws use the timeline
+		void addToTimeline(const sf::String & alias)
+		{
+			std::map<sf::String, std::size_t>::const_iterator slot = timelineSlots.find(alias);
+			if (slot != timelineSlots.cend())
+			{
+				timelineSeconds[slot->second] = 0.f;
+				return;
+			}
+			timelineSlots[alias] = timelineAliases.size();
+			timelineAliases.push_back(alias);
+			timelineSeconds.push_back(0.f);
+			timelineGroups.push_back(0);
+		}
+		void removeFromTimeline(const sf::String & alias)
+		{
+			// Swap with the last slot so the arrays stay dense
+			std::map<sf::String, std::size_t>::iterator slot = timelineSlots.find(alias);
+			if (slot != timelineSlots.end())
+			{
+				std::size_t index = slot->second;
+				std::size_t last = timelineAliases.size() - 1;
+				timelineSlots.erase(slot);
+				if (index != last)
+				{
+					timelineAliases[index] = timelineAliases[last];
+					timelineSeconds[index] = timelineSeconds[last];
+					timelineGroups[index] = timelineGroups[last];
+					timelineSlots[timelineAliases[index]] = index;
+				}
+				timelineAliases.pop_back();
+				timelineSeconds.pop_back();
+				timelineGroups.pop_back();
+			}
+		}
+		sf::IntRect currentRect(const sf::String & alias) const
+		{
+			// The frame time-less draws show: the timeline's once update() has run, the animation's own clock before that
+			return timelineActive ? animations.at(alias).currentTextureRect(getTime(alias)) : animations.at(alias).currentTextureRect();
+		}
+		template <class F>
+		void queueQuad(const sf::String & alias, F writeQuad)
+		{
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend())
+			{
+				// Counts as a use for the texture budget and reloads the texture if it was evicted
+				QueuedQuads & quads = queued[&sprites.getTexture(sprites.getHandle(alias))];
+				quads.vertices.resize(quads.vertices.size() + 4);
+				quads.owners.push_back(&animation->second);
+				writeQuad(animation->second, &quads.vertices[quads.vertices.size() - 4]);
+			}
+		}
+		template <class F>
+		void batchQuads(sf::RenderTarget & target, const sf::String & alias, std::size_t count, F writeQuad, sf::RenderStates states)
+		{
+			// writeQuad(quad, i) fills the i-th quad; large batches are built in parallel by the sprite handler
+			sf::VertexArray vertices(sf::Quads, count * 4);
+			sf::Vertex * quads = count ? &vertices[0] : nullptr;
+			sprites.buildQuads(count, [&](std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					writeQuad(quads + i * 4, i);
+				}
+			});
+			states.texture = &sprites.getTexture(sprites.getHandle(alias));
+			target.draw(vertices, states);
+		}
 	public:
 		// Constructors
-		AnimationHandler()
+		AnimationHandler         () : groupScales(1, 1.f), timeScale(1.f), timelineActive(false)
 		{
 		}
-		AnimationHandler(const AnimationHandler & rhs) : sprites(rhs.sprites), animations(rhs.animations)
+		explicit AnimationHandler(const std::shared_ptr<TextureCache> & textureCache) : sprites(TextureHandler(textureCache)), groupScales(1, 1.f), timeScale(1.f), timelineActive(false)
 		{
+			// Sprite sheets are loaded through the cache and shared with every other user of the same file
+		}
+		AnimationHandler         (const AnimationHandler & rhs) : sprites(rhs.sprites), animations(rhs.animations), timelineSlots(rhs.timelineSlots), timelineAliases(rhs.timelineAliases), timelineSeconds(rhs.timelineSeconds), timelineGroups(rhs.timelineGroups), groupScales(rhs.groupScales), timeScale(rhs.timeScale), timelineActive(rhs.timelineActive)
+		{
+			// Queued quads point at the other handler's textures and are not copied
 		}
 		// Destructor
 		~AnimationHandler()
@@ -104,6 +198,37 @@ namespace sfext
 			assert(("The requested animation does not exist", hasAnimation(alias)));
 			return animations.at(alias).getSpriteSheet();
 		}
+		sf::Time            getTime          (const sf::String & alias) const
+		{
+			std::map<sf::String, std::size_t>::const_iterator slot = timelineSlots.find(alias);
+			return slot != timelineSlots.cend() ? sf::seconds(timelineSeconds[slot->second]) : sf::Time::Zero;
+		}
+		std::uint32_t       getGroup         (const sf::String & alias) const
+		{
+			std::map<sf::String, std::size_t>::const_iterator slot = timelineSlots.find(alias);
+			return slot != timelineSlots.cend() ? timelineGroups[slot->second] : 0;
+		}
+		float               getTimeScale     () const
+		{
+			return timeScale;
+		}
+		float               getGroupTimeScale(std::uint32_t group) const
+		{
+			return group < groupScales.size() ? groupScales[group] : 1.f;
+		}
+		bool                isTimelineActive () const
+		{
+			return timelineActive;
+		}
+		std::size_t         getQueuedCount   () const
+		{
+			std::size_t count = 0;
+			for (const auto & texture : queued)
+			{
+				count += texture.second.owners.size();
+			}
+			return count;
+		}
 		// Mutators
 		void setFPS     (const sf::String & alias, float fps)
 		{
@@ -140,12 +265,51 @@ namespace sfext
 				animations.at(alias).setPosition(x, y);
 			}
 		}
+		void setParallelThreshold(std::size_t instanceCount)
+		{
+			sprites.setParallelThreshold(instanceCount);
+		}
+		void setTime          (const sf::String & alias, const sf::Time & time)
+		{
+			std::map<sf::String, std::size_t>::const_iterator slot = timelineSlots.find(alias);
+			if (slot != timelineSlots.cend())
+			{
+				timelineSeconds[slot->second] = time.asSeconds();
+			}
+		}
+		void setGroup         (const sf::String & alias, std::uint32_t group)
+		{
+			// Every animation starts in group 0
+			std::map<sf::String, std::size_t>::const_iterator slot = timelineSlots.find(alias);
+			if (slot != timelineSlots.cend())
+			{
+				if (groupScales.size() <= group)
+				{
+					groupScales.resize(group + 1, 1.f);
+				}
+				timelineGroups[slot->second] = group;
+			}
+		}
+		void setTimeScale     (float scale)
+		{
+			// Applies to every group; 0 pauses the whole timeline and negative scales play it backwards
+			timeScale = scale;
+		}
+		void setGroupTimeScale(std::uint32_t group, float scale)
+		{
+			if (groupScales.size() <= group)
+			{
+				groupScales.resize(group + 1, 1.f);
+			}
+			groupScales[group] = scale;
+		}
 		// Utilities
 		bool addAnimation   (const sf::String & filePath, const sf::String & alias, const sf::Vector2f & start, const sf::Vector2f & dimensions, const sf::Vector2f & offset, const sf::Vector2u & rowsAndColumns, float fps = 24.f)
 		{
 			if (sprites.addTexture(filePath, alias))
 			{
 				animations[alias] = Animation(sprites.find(alias)->second, start, dimensions, offset, rowsAndColumns, fps);
+				addToTimeline(alias);
 				return true;
 			}
 			return false;
@@ -155,6 +319,7 @@ namespace sfext
 			if (sprites.addTexture(image, alias))
 			{
 				animations[alias] = Animation(sprites.find(alias)->second, start, dimensions, offset, rowsAndColumns, fps);
+				addToTimeline(alias);
 				return true;
 			}
 			return false;
@@ -165,19 +330,53 @@ namespace sfext
 		}
 		bool removeAnimation(const sf::String & alias)
 		{
+			if (hasAnimation(alias))
+			{
+				// Other animations may share the texture, so only this one's quads are dropped, keeping the order of the rest
+				const Animation * removed = &animations.at(alias);
+				std::map<const sf::Texture *, QueuedQuads>::iterator texture = queued.find(removed->getTexture());
+				if (texture != queued.end())
+				{
+					QueuedQuads & quads = texture->second;
+					std::size_t kept = 0;
+					for (std::size_t i = 0; i < quads.owners.size(); ++i)
+					{
+						if (quads.owners[i] != removed)
+						{
+							std::copy(quads.vertices.begin() + i * 4, quads.vertices.begin() + i * 4 + 4, quads.vertices.begin() + kept * 4);
+							quads.owners[kept++] = quads.owners[i];
+						}
+					}
+					quads.vertices.resize(kept * 4);
+					quads.owners.resize(kept);
+					if (kept == 0)
+					{
+						// The texture may be destroyed with the animation
+						queued.erase(texture);
+					}
+				}
+			}
 			if (sprites.removeTexture(alias))
 			{
 				ConstAnimationIterator animation = animations.find(alias);
 				animations.erase(animation);
+				removeFromTimeline(alias);
 				return true;
 			}
 			return false;
 		}
-		void draw           (sf::RenderTarget & target, sf::String & alias, sf::RenderStates states = sf::RenderStates::Default) const
+		void draw           (sf::RenderTarget & target, const sf::String & alias, sf::RenderStates states = sf::RenderStates::Default) const
 		{
 			if (hasAnimation(alias))
 			{
-				animations.at(alias).draw(target);
+				if (timelineActive)
+				{
+					animations.at(alias).draw(target, getTime(alias), states);
+				}
+				else
+				{
+					animations.at(alias).draw(target, states);
+				}
 			}
 		}
 		void draw           (sf::RenderTarget & target, const sf::String & alias, std::size_t frame, sf::RenderStates states = sf::RenderStates::Default) const
@@ -198,7 +397,14 @@ namespace sfext
 		{
 			if (hasAnimation(alias))
 			{
-				animations.at(alias).draw(target, position, states);
+				if (timelineActive)
+				{
+					animations.at(alias).draw(target, position, getTime(alias), states);
+				}
+				else
+				{
+					animations.at(alias).draw(target, position, states);
+				}
 			}
 		}
 		void draw           (sf::RenderTarget & target, const sf::String & alias, const sf::Vector2f & position, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
@@ -215,91 +421,251 @@ namespace sfext
 				animations.at(alias).draw(target, position, frame, states);
 			}
 		}
-		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, sf::RenderStates states = sf::RenderStates::Default) const
+		void draw           (sf::RenderTarget & target, const sf::String & alias, const AnimationClip & clip, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			// Plays a clip from the alias's sprite sheet; the animation's own frame layout and fps are ignored
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && clip.getFrameCount() != 0)
+			{
+				const sf::Sprite & sheet = animation->second.getSpriteSheet();
+				SpriteBatch::drawQuad(target, sheet.getTexture(), clip.rectAt(time), sheet.getColor(), sheet.getTransform(), states);
+			}
+		}
+		void draw           (sf::RenderTarget & target, const sf::String & alias, const AnimationClip & clip, const sf::Vector2f & position, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && clip.getFrameCount() != 0)
+			{
+				const sf::Sprite & sheet = animation->second.getSpriteSheet();
+				SpriteBatch::drawQuad(target, sheet.getTexture(), clip.rectAt(time), sheet.getColor(), SpriteBatch::getTransformAt(sheet, position), states);
+			}
+		}
+		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, sf::RenderStates states = sf::RenderStates::Default)
 		{
 			if (hasAnimation(alias))
 			{
-				sf::IntRect rectangle = animations.at(alias).currentTextureRect();
-				sf::VertexArray vertices(sf::Quads);
-				for (const sf::Vector2f & position : positions)
-				{
-					vertices.append(sf::Vertex(position, sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top + rectangle.height))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top + rectangle.height))));
-				}
-				states.texture = &sprites.getTextureHandler().getTexture(alias);
-				target.draw(vertices, states);
+				sprites.batch(target, alias, positions, currentRect(alias), states);
 			}
 		}
-		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, std::size_t frame, sf::RenderStates states = sf::RenderStates::Default) const
+		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, std::size_t frame, sf::RenderStates states = sf::RenderStates::Default)
 		{
 			if (hasAnimation(alias))
 			{
-				sf::IntRect rectangle = animations.at(alias).currentTextureRect(frame);
-				sf::VertexArray vertices(sf::Quads);
-				for (const sf::Vector2f & position : positions)
+				sprites.batch(target, alias, positions, animations.at(alias).currentTextureRect(frame), states);
+			}
+		}
+		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			if (hasAnimation(alias))
+			{
+				sprites.batch(target, alias, positions, animations.at(alias).currentTextureRect(time), states);
+			}
+		}
+		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<std::size_t> & frames, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && positions.size() == frames.size())
+			{
+				const std::vector<sf::IntRect> & rectangles = animation->second.getFrameRects();
+				batchQuads(target, alias, positions.size(), [&](sf::Vertex * quad, std::size_t i)
 				{
-					vertices.append(sf::Vertex(position, sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top + rectangle.height))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top + rectangle.height))));
-				}
-				states.texture = &sprites.getTextureHandler().getTexture(alias);
-				target.draw(vertices, states);
+					SpriteBatch::writeQuad(quad, positions[i], rectangles[frames[i] % rectangles.size()]);
+				}, states);
+			}
+		}
+		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::Time> & times, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && positions.size() == times.size())
+			{
+				const Animation & frameSource = animation->second;
+				batchQuads(target, alias, positions.size(), [&](sf::Vertex * quad, std::size_t i)
+				{
+					SpriteBatch::writeQuad(quad, positions[i], frameSource.currentTextureRect(times[i]));
+				}, states);
+			}
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Like batch(), but only the instances overlapping 'area' (or the area shown by 'view') are built and drawn
+			if (hasAnimation(alias))
+			{
+				return sprites.batchVisible(target, alias, positions, currentRect(alias), area, states);
+			}
+			CullingStats stats = { 0, 0 };
+			return stats;
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, std::size_t frame, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			if (hasAnimation(alias))
+			{
+				return sprites.batchVisible(target, alias, positions, animations.at(alias).currentTextureRect(frame), area, states);
 			}
+			CullingStats stats = { 0, 0 };
+			return stats;
 		}
-		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default) const
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::Time & time, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
 		{
 			if (hasAnimation(alias))
 			{
-				sf::IntRect rectangle = animations.at(alias).currentTextureRect(time);
-				sf::VertexArray vertices(sf::Quads);
-				for (const sf::Vector2f & position : positions)
+				return sprites.batchVisible(target, alias, positions, animations.at(alias).currentTextureRect(time), area, states);
+			}
+			CullingStats stats = { 0, 0 };
+			return stats;
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<std::size_t> & frames, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			CullingStats stats = { 0, 0 };
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && positions.size() == frames.size())
+			{
+				// Every frame of an animation has the same dimensions, so one quad size culls them all
+				const std::vector<sf::IntRect> & rectangles = animation->second.getFrameRects();
+				std::vector<std::uint32_t> visible;
+				stats.visible = cullQuads(positions, animation->second.getDimensions(), area, visible);
+				stats.culled = positions.size() - stats.visible;
+				batchQuads(target, alias, stats.visible, [&](sf::Vertex * quad, std::size_t i)
 				{
-					vertices.append(sf::Vertex(position, sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top + rectangle.height))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top + rectangle.height))));
-				}
-				states.texture = &sprites.getTextureHandler().getTexture(alias);
-				target.draw(vertices, states);
+					SpriteBatch::writeQuad(quad, positions[visible[i]], rectangles[frames[visible[i]] % rectangles.size()]);
+				}, states);
 			}
+			return stats;
 		}
-		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<std::size_t> & frames, sf::RenderStates states = sf::RenderStates::Default) const
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::Time> & times, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasAnimation(alias) && positions.size() == frames.size())
+			CullingStats stats = { 0, 0 };
+			ConstAnimationIterator animation = animations.find(alias);
+			if (animation != animations.cend() && positions.size() == times.size())
 			{
-				sf::IntRect rectangle;
-				sf::VertexArray vertices(sf::Quads);
-				for (unsigned int i = 0; i < positions.size(); ++i)
+				const Animation & frameSource = animation->second;
+				std::vector<std::uint32_t> visible;
+				stats.visible = cullQuads(positions, frameSource.getDimensions(), area, visible);
+				stats.culled = positions.size() - stats.visible;
+				batchQuads(target, alias, stats.visible, [&](sf::Vertex * quad, std::size_t i)
 				{
-					rectangle = animations.at(alias).currentTextureRect(frames.at(i));
-					vertices.append(sf::Vertex(positions.at(i), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top + rectangle.height))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top + rectangle.height))));
-				}
-				states.texture = &sprites.getTextureHandler().getTexture(alias);
-				target.draw(vertices, states);
+					SpriteBatch::writeQuad(quad, positions[visible[i]], frameSource.currentTextureRect(times[visible[i]]));
+				}, states);
+			}
+			return stats;
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, alias, positions, getViewBounds(view), states);
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, std::size_t frame, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, alias, positions, frame, getViewBounds(view), states);
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::Time & time, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, alias, positions, time, getViewBounds(view), states);
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<std::size_t> & frames, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, alias, positions, frames, getViewBounds(view), states);
+		}
+		CullingStats batchVisible   (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::Time> & times, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, alias, positions, times, getViewBounds(view), states);
+		}
+		void queue          (const sf::String & alias)
+		{
+			// Queued animations are drawn by flush(), one draw call per texture
+			if (timelineActive)
+			{
+				queue(alias, getTime(alias));
+				return;
+			}
+			queueQuad(alias, [](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad);
+			});
+		}
+		void queue          (const sf::String & alias, std::size_t frame)
+		{
+			queueQuad(alias, [frame](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad, frame);
+			});
+		}
+		void queue          (const sf::String & alias, const sf::Time & time)
+		{
+			queueQuad(alias, [&time](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad, time);
+			});
+		}
+		void queue          (const sf::String & alias, const sf::Vector2f & position)
+		{
+			if (timelineActive)
+			{
+				queue(alias, position, getTime(alias));
+				return;
+			}
+			queueQuad(alias, [&position](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad, position);
+			});
+		}
+		void queue          (const sf::String & alias, const sf::Vector2f & position, const sf::Time & time)
+		{
+			queueQuad(alias, [&position, &time](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad, position, time);
+			});
+		}
+		void queue          (const sf::String & alias, const sf::Vector2f & position, std::size_t frame)
+		{
+			queueQuad(alias, [&position, frame](const Animation & animation, sf::Vertex * quad)
+			{
+				animation.writeQuad(quad, position, frame);
+			});
+		}
+		void queue          (const sf::String & alias, const AnimationClip & clip, const sf::Vector2f & position, const sf::Time & time)
+		{
+			if (clip.getFrameCount() != 0)
+			{
+				queueQuad(alias, [&](const Animation & animation, sf::Vertex * quad)
+				{
+					animation.writeQuad(quad, clip.rectAt(time), SpriteBatch::getTransformAt(animation.getSpriteSheet(), position));
+				});
 			}
 		}
-		void batch          (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::Time> & times, sf::RenderStates states = sf::RenderStates::Default) const
+		void flush          (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasAnimation(alias) && positions.size() == times.size())
+			// Quads sharing a texture keep their queued order, but textures are drawn one after another, so overlapping
+			// animations on different textures should be flushed separately when their order matters
+			for (auto & texture : queued)
 			{
-				sf::IntRect rectangle;
-				sf::VertexArray vertices(sf::Quads);
-				for (unsigned int i = 0; i < positions.size(); ++i)
+				if (!texture.second.vertices.empty())
 				{
-					rectangle = animations.at(alias).currentTextureRect(times.at(i));
-					vertices.append(sf::Vertex(positions.at(i), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left + rectangle.width), static_cast<float>(rectangle.top + rectangle.height))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top + rectangle.height))));
+					states.texture = texture.first;
+					target.draw(&texture.second.vertices[0], texture.second.vertices.size(), sf::Quads, states);
+					texture.second.vertices.clear();
+					texture.second.owners.clear();
 				}
-				states.texture = &sprites.getTextureHandler().getTexture(alias);
-				target.draw(vertices, states);
+			}
+		}
+		void clearQueue     ()
+		{
+			queued.clear();
+		}
+		void update         (const sf::Time & deltaTime)
+		{
+			// Advances every animation from one time source; the per-group steps are worked out once so the loop is a gather and an add
+			timelineActive = true;
+			float seconds = deltaTime.asSeconds() * timeScale;
+			groupSteps.resize(groupScales.size());
+			for (std::size_t group = 0; group < groupScales.size(); ++group)
+			{
+				groupSteps[group] = seconds * groupScales[group];
+			}
+			float * times = timelineSeconds.empty() ? nullptr : &timelineSeconds[0];
+			const std::uint32_t * groups = timelineGroups.empty() ? nullptr : &timelineGroups[0];
+			const float * steps = &groupSteps[0];
+			for (std::size_t i = 0; i < timelineSeconds.size(); ++i)
+			{
+				times[i] += steps[groups[i]];
 			}
 		}
 		// Iterators
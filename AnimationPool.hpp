@@ -0,0 +1,169 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "Animation.hpp"
+#include "AnimationClip.hpp"
+#include "SpriteBatch.hpp"
+
+namespace sfext
+{
+	// Plain data so a pool of thousands copies and iterates like an array of floats
+	struct AnimationInstance
+	{
+		std::uint32_t definition;
+		float         startTime; // Pool time, in seconds, at which the instance shows its first frame
+		float         speed;     // 1 plays the clip at its authored speed
+		sf::Vector2f  position;
+	};
+
+	class AnimationPool final
+	{
+	private:
+		struct Definition
+		{
+			std::shared_ptr<const AnimationClip> clip;
+			std::uint32_t                        texture; // Index into 'textures'
+		};
+		std::vector<Definition>          definitions;
+		std::vector<const sf::Texture *> textures;
+		std::vector<AnimationInstance>   instances;
+		std::vector<sf::Vertex>          vertices; // Rebuilt by draw(), grouped by texture
+		std::vector<std::uint32_t>       offsets;
+	public:
+		// Constructors
+		AnimationPool()
+		{
+		}
+		AnimationPool(const AnimationPool & rhs) : definitions(rhs.definitions), textures(rhs.textures), instances(rhs.instances)
+		{
+		}
+		// Destructor
+		~AnimationPool()
+		{
+		}
+		// Accessors
+		std::size_t                            getSize           () const
+		{
+			return instances.size();
+		}
+		std::size_t                            getDefinitionCount() const
+		{
+			return definitions.size();
+		}
+		const AnimationInstance &              getInstance       (std::size_t index) const
+		{
+			assert(("The instance requested does not exist", index < instances.size()));
+			return instances[index];
+		}
+		AnimationInstance &                    getInstance       (std::size_t index)
+		{
+			// Instances can be moved or retimed in place
+			assert(("The instance requested does not exist", index < instances.size()));
+			return instances[index];
+		}
+		const std::vector<AnimationInstance> & getInstances      () const
+		{
+			return instances;
+		}
+		std::vector<AnimationInstance> &       getInstances      ()
+		{
+			return instances;
+		}
+		const std::vector<sf::Vertex> &        getVertices       () const
+		{
+			// The quads of the last draw: one range per texture, in the order the textures were first added
+			return vertices;
+		}
+		// Utilities
+		std::uint32_t addDefinition(const sf::Texture & texture, const std::shared_ptr<const AnimationClip> & clip)
+		{
+			// Returns the id instances refer to; the clip is shared, not copied
+			assert(("A definition needs a clip with at least one frame", clip && clip->getFrameCount() != 0));
+			Definition definition = { clip, 0 };
+			while (definition.texture < textures.size() && textures[definition.texture] != &texture)
+			{
+				++definition.texture;
+			}
+			if (definition.texture == textures.size())
+			{
+				textures.push_back(&texture);
+			}
+			definitions.push_back(definition);
+			return static_cast<std::uint32_t>(definitions.size() - 1);
+		}
+		std::uint32_t addDefinition(const Animation & animation)
+		{
+			// Converts a grid animation into a looping clip with one frame every 1 / fps seconds
+			assert(("The animation has no sprite sheet", animation.getTexture() != nullptr));
+			std::shared_ptr<AnimationClip> clip = std::make_shared<AnimationClip>();
+			sf::Time frameTime = sf::seconds(animation.getFPS() > 0.f ? 1.f / animation.getFPS() : 0.f);
+			for (const sf::IntRect & rectangle : animation.getFrameRects())
+			{
+				clip->addFrame(rectangle, frameTime);
+			}
+			return addDefinition(*animation.getTexture(), clip);
+		}
+		std::size_t   spawn        (std::uint32_t definition, const sf::Vector2f & position, const sf::Time & startTime, float speed = 1.f)
+		{
+			// Returns the index of the new instance
+			assert(("The definition requested does not exist", definition < definitions.size()));
+			AnimationInstance instance = { definition, startTime.asSeconds(), speed, position };
+			instances.push_back(instance);
+			return instances.size() - 1;
+		}
+		void          remove       (std::size_t index)
+		{
+			// Swaps the last instance into 'index' to keep the pool contiguous, so that instance's index changes
+			assert(("The instance requested does not exist", index < instances.size()));
+			instances[index] = instances.back();
+			instances.pop_back();
+		}
+		void          clear        ()
+		{
+			instances.clear();
+		}
+		void          draw         (sf::RenderTarget & target, const sf::Time & time, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// One draw call per distinct texture, whatever the number of instances or definitions
+			offsets.assign(textures.size() + 1, 0);
+			for (const AnimationInstance & instance : instances)
+			{
+				++offsets[definitions[instance.definition].texture + 1];
+			}
+			for (std::size_t i = 1; i < offsets.size(); ++i)
+			{
+				offsets[i] += offsets[i - 1];
+			}
+			vertices.resize(instances.size() * 4);
+			float now = time.asSeconds();
+			for (const AnimationInstance & instance : instances)
+			{
+				const Definition & definition = definitions[instance.definition];
+				std::uint32_t slot = offsets[definition.texture]++;
+				SpriteBatch::writeQuad(&vertices[slot * 4], instance.position, definition.clip->rectAt(sf::seconds((now - instance.startTime) * instance.speed)));
+			}
+			// Each offset now marks the end of its texture's range
+			std::uint32_t begin = 0;
+			for (std::size_t texture = 0; texture < textures.size(); ++texture)
+			{
+				std::uint32_t end = offsets[texture];
+				if (end > begin)
+				{
+					states.texture = textures[texture];
+					target.draw(&vertices[begin * 4], (end - begin) * 4, sf::Quads, states);
+				}
+				begin = end;
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "SML.hpp"
+
+#include <SFML/System/String.hpp>
+
+namespace ash
+{
+	typedef std::shared_ptr<const SML> SMLSnapshot;
+
+	// getSnapshot uses std::atomic_load on a shared_ptr, which libstdc++ and libc++ implement with a global pool of mutexes,
+	// so those reads are not lock-free; hot readers should go through an SMLReader instead
+	class ConcurrentSML final
+	{
+	private:
+		std::shared_ptr<const SML>              current;
+		std::atomic<std::uint64_t>              version;
+		std::vector<std::function<void(SML &)>> pending;
+		mutable std::mutex                      writerMutex;
+		// Applies every queued mutation to a private copy of the current values and swaps it in
+		void publishLocked(const std::function<void(SML &)> & mutation)
+		{
+			std::shared_ptr<SML> draft = std::make_shared<SML>(*std::atomic_load(&current));
+			for (const auto & queued : pending)
+			{
+				queued(*draft);
+			}
+			if (mutation)
+			{
+				mutation(*draft);
+			}
+			pending.clear();
+			std::atomic_store(&current, std::shared_ptr<const SML>(std::move(draft)));
+			// Bumped after the store, so a reader that sees the new version also sees the new snapshot
+			version.fetch_add(1, std::memory_order_release);
+		}
+	public:
+		// Constructors
+		ConcurrentSML         () : current(std::make_shared<SML>()), version(0)
+		{
+		}
+		explicit ConcurrentSML(const sf::String & fileName) : current(std::make_shared<SML>(fileName)), version(0)
+		{
+		}
+		explicit ConcurrentSML(const SML & sml) : current(std::make_shared<SML>(sml)), version(0)
+		{
+		}
+		ConcurrentSML         (const ConcurrentSML & rhs) : current(rhs.getSnapshot()), version(0)
+		{
+			// Only the published values are copied; mutations still queued on rhs stay with rhs
+		}
+		// Destructor
+		~ConcurrentSML()
+		{
+		}
+		// Accessors
+		SMLSnapshot getSnapshot    () const
+		{
+			// Readers that hold on to the snapshot (e.g. for a whole frame) pay no further synchronization
+			return std::atomic_load(&current);
+		}
+		sf::String  getValue       (const sf::String & variable, const sf::String & tag) const
+		{
+			return getSnapshot()->getValue(variable, tag);
+		}
+		std::uint64_t getVersion   () const
+		{
+			// Incremented by every publish; a plain atomic load, so it is lock-free wherever 64-bit atomics are
+			return version.load(std::memory_order_acquire);
+		}
+		std::size_t getPendingCount() const
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			return pending.size();
+		}
+		// Mutators
+		void setValue      (const sf::String & variable, const sf::String & tag, const sf::String & value)
+		{
+			// Queued until the next call to publish()
+			std::lock_guard<std::mutex> lock(writerMutex);
+			pending.push_back([variable, tag, value](SML & sml)
+			{
+				sml.setValue(variable, tag, value);
+			});
+		}
+		void removeTag     (const sf::String & variable, const sf::String & tag)
+		{
+			// Queued until the next call to publish()
+			std::lock_guard<std::mutex> lock(writerMutex);
+			pending.push_back([variable, tag](SML & sml)
+			{
+				sml.removeTag(variable, tag);
+			});
+		}
+		void removeVariable(const sf::String & variable)
+		{
+			// Queued until the next call to publish()
+			std::lock_guard<std::mutex> lock(writerMutex);
+			pending.push_back([variable](SML & sml)
+			{
+				sml.removeVariable(variable);
+			});
+		}
+		// Utilities
+		bool hasVariable   (const sf::String & variable) const
+		{
+			return getSnapshot()->hasVariable(variable);
+		}
+		bool hasTag        (const sf::String & variable, const sf::String & tag) const
+		{
+			return getSnapshot()->hasTag(variable, tag);
+		}
+		void publish       ()
+		{
+			// Makes every queued mutation visible to readers at once
+			std::lock_guard<std::mutex> lock(writerMutex);
+			if (!pending.empty())
+			{
+				publishLocked(nullptr);
+			}
+		}
+		void update        (const std::function<void(SML &)> & mutation)
+		{
+			// Applies the queued mutations followed by 'mutation' and publishes the result in one step
+			std::lock_guard<std::mutex> lock(writerMutex);
+			publishLocked(mutation);
+		}
+		void discardPending()
+		{
+			std::lock_guard<std::mutex> lock(writerMutex);
+			pending.clear();
+		}
+		void updateFile    () const
+		{
+			// Writes the currently published values; queued mutations are not included
+			SML copy(*getSnapshot());
+			copy.updateFile();
+		}
+	};
+
+	// Per-thread view of a ConcurrentSML: keeps the last snapshot and only reloads it when the store's version changed,
+	// so reads between publishes cost one atomic integer load and take no lock
+	class SMLReader final
+	{
+	private:
+		const ConcurrentSML * store;
+		std::uint64_t         version;
+		SMLSnapshot           snapshot;
+	public:
+		// Constructors
+		explicit SMLReader(const ConcurrentSML & store) : store(&store), version(store.getVersion()), snapshot(store.getSnapshot())
+		{
+			// The version is read first: the snapshot may be newer than it, which only costs one extra reload
+		}
+		SMLReader         (const SMLReader & rhs) : store(rhs.store), version(rhs.version), snapshot(rhs.snapshot)
+		{
+		}
+		// Destructor
+		~SMLReader()
+		{
+		}
+		// Assignment
+		SMLReader & operator=(const SMLReader & rhs)
+		{
+			store = rhs.store;
+			version = rhs.version;
+			snapshot = rhs.snapshot;
+			return *this;
+		}
+		// Accessors
+		const SML & get     ()
+		{
+			// The store must outlive the reader, and a reader must not be shared between threads
+			std::uint64_t latest = store->getVersion();
+			if (latest != version)
+			{
+				snapshot = store->getSnapshot();
+				version = latest;
+			}
+			return *snapshot;
+		}
+		sf::String  getValue(const sf::String & variable, const sf::String & tag)
+		{
+			return get().getValue(variable, tag);
+		}
+	};
+}
\ No newline at end of file
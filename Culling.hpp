@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace sfext
+{
+	struct CullingStats
+	{
+		std::size_t visible;
+		std::size_t culled;
+	};
+
+	inline sf::FloatRect getViewBounds(const sf::View & view)
+	{
+		// World-space area shown by 'view'; rotated views give the axis-aligned box around the visible area
+		float radians = view.getRotation() * 3.14159265358979f / 180.f;
+		float cosine = std::fabs(std::cos(radians));
+		float sine = std::fabs(std::sin(radians));
+		sf::Vector2f size(view.getSize().x * cosine + view.getSize().y * sine, view.getSize().x * sine + view.getSize().y * cosine);
+		return sf::FloatRect(view.getCenter() - size * .5f, size);
+	}
+
+	namespace culling
+	{
+		const std::size_t BlockSize = 256;
+
+		inline std::size_t compact(const std::uint8_t * mask, std::size_t first, std::size_t count, std::uint32_t * visible)
+		{
+			// Scalar, but branch-free: every index is written and the output only advances past overlapping quads
+			std::size_t written = 0;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				visible[written] = static_cast<std::uint32_t>(first + i);
+				written += mask[i];
+			}
+			return written;
+		}
+	}
+
+	// Fills 'visible' with the indices of the quads of 'size' placed at 'positions' that overlap 'area' and returns how many there are
+	inline std::size_t cullQuads(const std::vector<sf::Vector2f> & positions, const sf::Vector2f & size, const sf::FloatRect & area, std::vector<std::uint32_t> & visible)
+	{
+		// Works in blocks: a mask pass with no stores but the mask, which GCC and Clang vectorize at -O3, then a scalar compaction
+		float minX = area.left - size.x;
+		float maxX = area.left + area.width;
+		float minY = area.top - size.y;
+		float maxY = area.top + area.height;
+		visible.resize(positions.size());
+		const sf::Vector2f * position = positions.data();
+		std::uint8_t mask[culling::BlockSize];
+		std::size_t count = 0;
+		for (std::size_t first = 0; first < positions.size(); first += culling::BlockSize)
+		{
+			std::size_t block = std::min(culling::BlockSize, positions.size() - first);
+			for (std::size_t i = 0; i < block; ++i)
+			{
+				float x = position[first + i].x;
+				float y = position[first + i].y;
+				mask[i] = static_cast<std::uint8_t>((x > minX) & (x < maxX) & (y > minY) & (y < maxY));
+			}
+			count += culling::compact(mask, first, block, &visible[count]);
+		}
+		visible.resize(count);
+		return count;
+	}
+
+	inline std::size_t cullQuads(const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::FloatRect & area, std::vector<std::uint32_t> & visible)
+	{
+		// As above, with each quad sized by its own texture rectangle (flipped rectangles by their absolute size)
+		float maxX = area.left + area.width;
+		float maxY = area.top + area.height;
+		visible.resize(positions.size());
+		const sf::Vector2f * position = positions.data();
+		const sf::IntRect * rectangle = rectangles.data();
+		std::uint8_t mask[culling::BlockSize];
+		std::size_t count = 0;
+		for (std::size_t first = 0; first < positions.size(); first += culling::BlockSize)
+		{
+			std::size_t block = std::min(culling::BlockSize, positions.size() - first);
+			for (std::size_t i = 0; i < block; ++i)
+			{
+				float x = position[first + i].x;
+				float y = position[first + i].y;
+				float width = static_cast<float>(std::abs(rectangle[first + i].width));
+				float height = static_cast<float>(std::abs(rectangle[first + i].height));
+				mask[i] = static_cast<std::uint8_t>((x + width > area.left) & (x < maxX) & (y + height > area.top) & (y < maxY));
+			}
+			count += culling::compact(mask, first, block, &visible[count]);
+		}
+		visible.resize(count);
+		return count;
+	}
+}
\ No newline at end of file
@@ -1,62 +1,204 @@
 #pragma once
 
 #include <map>
+#include <set>
+#include <future>
+#include <memory>
+#include <vector>
 
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/String.hpp>
 
+#include "HandleTable.hpp"
+#include "ThreadPool.hpp"
+
 namespace sfext
 {
 	class FontHandler final
 	{
 	private:
-		std::map<sf::String, sf::Font> fonts;
+		std::map<sf::String, std::shared_ptr<sf::Font>> fonts;
+		std::map<sf::String, ResourceHandle>            handles;
+		HandleTable<sf::Font *>                         slots;
+		std::map<sf::String, std::set<unsigned int>>    characterSizes; // Sizes known to have a glyph page, for the memory report
+		void registerFont(const sf::String & fontAlias, const std::shared_ptr<sf::Font> & font)
+		{
+			// Replacing an existing alias keeps its handle; other handlers sharing the old font keep theirs
+			fonts[fontAlias] = font;
+			characterSizes.erase(fontAlias);
+			std::map<sf::String, ResourceHandle>::const_iterator handle = handles.find(fontAlias);
+			if (handle == handles.cend())
+			{
+				handles[fontAlias] = slots.insert(font.get());
+			}
+			else
+			{
+				*slots.get(handle->second) = font.get();
+			}
+		}
+		static std::size_t rasterize(sf::Font & font, const std::vector<unsigned int> & sizes, const sf::String & charset, bool bold)
+		{
+			std::size_t glyphs = 0;
+			for (unsigned int size : sizes)
+			{
+				for (sf::Uint32 character : charset)
+				{
+					font.getGlyph(character, size, bold);
+					++glyphs;
+				}
+			}
+			return glyphs;
+		}
 	public:
 		// Constructors
 		FontHandler()
 		{
 		}
-		FontHandler(const FontHandler & rhs) : fonts(rhs.fonts)
+		FontHandler(const FontHandler & rhs) : fonts(rhs.fonts), handles(rhs.handles), slots(rhs.slots), characterSizes(rhs.characterSizes)
 		{
+			// Copies share the same font objects, along with the glyphs they have already rasterized
 		}
 		// Destructor
 		~FontHandler()
 		{
 		}
+		// Assignment
+		FontHandler & operator =(const FontHandler & rhs)
+		{
+			fonts = rhs.fonts;
+			handles = rhs.handles;
+			slots = rhs.slots;
+			characterSizes = rhs.characterSizes;
+			return *this;
+		}
 		// Accessors
-		const sf::Font * getFont(const sf::String & fontAlias) const
+		const sf::Font *          getFont      (const sf::String & fontAlias) const
 		{
-			const sf::Font * font = nullptr;
-			if (hasFont(fontAlias))
+			std::map<sf::String, std::shared_ptr<sf::Font>>::const_iterator font = fonts.find(fontAlias);
+			return font != fonts.cend() ? font->second.get() : nullptr;
+		}
+		const sf::Font *          getFont      (const ResourceHandle & handle) const
+		{
+			return hasFont(handle) ? *slots.get(handle) : nullptr;
+		}
+		std::shared_ptr<sf::Font> getSharedFont(const sf::String & fontAlias) const
+		{
+			std::map<sf::String, std::shared_ptr<sf::Font>>::const_iterator font = fonts.find(fontAlias);
+			return font != fonts.cend() ? font->second : nullptr;
+		}
+		ResourceHandle            getHandle    (const sf::String & fontAlias) const
+		{
+			// Resolve once and keep the handle; an invalid handle is returned for unknown aliases
+			std::map<sf::String, ResourceHandle>::const_iterator handle = handles.find(fontAlias);
+			return handle != handles.cend() ? handle->second : ResourceHandle();
+		}
+		std::size_t               getGlyphBytes(const sf::String & fontAlias) const
+		{
+			// Size of the glyph textures of the character sizes that were prewarmed or tracked, at four bytes per texel
+			std::size_t bytes = 0;
+			std::map<sf::String, std::shared_ptr<sf::Font>>::const_iterator font = fonts.find(fontAlias);
+			std::map<sf::String, std::set<unsigned int>>::const_iterator sizes = characterSizes.find(fontAlias);
+			if (font != fonts.cend() && sizes != characterSizes.cend())
+			{
+				for (unsigned int size : sizes->second)
+				{
+					sf::Vector2u texels = font->second->getTexture(size).getSize();
+					bytes += static_cast<std::size_t>(texels.x) * texels.y * 4;
+				}
+			}
+			return bytes;
+		}
+		std::size_t               getGlyphBytes() const
+		{
+			// Fonts shared between aliases are counted once per alias
+			std::size_t bytes = 0;
+			for (const auto & font : fonts)
 			{
-				font = &fonts.at(fontAlias);
+				bytes += getGlyphBytes(font.first);
 			}
-			return font;
+			return bytes;
 		}
 		// Utilities
-		bool addFont   (const sf::String & filePath, const sf::String & fontAlias)
+		bool                     addFont           (const sf::String & filePath, const sf::String & fontAlias)
+		{
+			std::shared_ptr<sf::Font> font = std::make_shared<sf::Font>();
+			if (font->loadFromFile(filePath))
+			{
+				registerFont(fontAlias, font);
+				return true;
+			}
+			return false;
+		}
+		bool                     addFont           (const std::shared_ptr<sf::Font> & font, const sf::String & fontAlias)
 		{
-			sf::Font font;
-			if (font.loadFromFile(filePath))
+			// Shares a font owned elsewhere (another handler, ...)
+			if (font)
 			{
-				fonts[fontAlias] = font;
+				registerFont(fontAlias, font);
 				return true;
 			}
 			return false;
 		}
-		bool hasFont   (const sf::String & fontAlias) const
+		bool                     hasFont           (const sf::String & fontAlias) const
 		{
 			return fonts.find(fontAlias) != fonts.cend();
 		}
-		bool removeFont(const sf::String & fontAlias)
+		bool                     hasFont           (const ResourceHandle & handle) const
+		{
+			return slots.contains(handle);
+		}
+		bool                     removeFont        (const sf::String & fontAlias)
 		{
-			std::map<sf::String, sf::Font>::const_iterator font = fonts.find(fontAlias);
+			std::map<sf::String, std::shared_ptr<sf::Font>>::const_iterator font = fonts.find(fontAlias);
 			if (font != fonts.cend())
 			{
+				slots.erase(handles.at(fontAlias));
+				handles.erase(fontAlias);
+				characterSizes.erase(fontAlias);
 				fonts.erase(font);
 				return true;
 			}
 			return false;
 		}
+		void                     trackCharacterSize(const sf::String & fontAlias, unsigned int size)
+		{
+			// Includes a size rasterized lazily (by drawing text) in getGlyphBytes
+			if (hasFont(fontAlias))
+			{
+				characterSizes[fontAlias].insert(size);
+			}
+		}
+		std::size_t              prewarm           (const sf::String & fontAlias, const std::vector<unsigned int> & sizes, const sf::String & charset, bool bold = false)
+		{
+			// Rasterizes every character of 'charset' at every size now, so text using them later does not stall on glyph loading
+			// Returns the number of glyphs requested, 0 for unknown aliases
+			std::map<sf::String, std::shared_ptr<sf::Font>>::const_iterator font = fonts.find(fontAlias);
+			if (font == fonts.cend())
+			{
+				return 0;
+			}
+			characterSizes[fontAlias].insert(sizes.cbegin(), sizes.cend());
+			return rasterize(*font->second, sizes, charset, bold);
+		}
+		std::future<std::size_t> prewarmAsync      (const sf::String & fontAlias, const std::vector<unsigned int> & sizes, const sf::String & charset, bool bold = false, oak::ThreadPool & pool = oak::ThreadPool::getBackground())
+		{
+			// Same as prewarm, on a worker of the background pool by default, so batch building on the shared pool never queues
+			// behind it; SFML gives the worker its own OpenGL context for the glyph texture updates
+			// sf::Font is not thread-safe: nothing may draw, measure or prewarm with this font until the future is ready
+			// The worker keeps the font alive, so removing the alias meanwhile is safe
+			std::shared_ptr<sf::Font> font = getSharedFont(fontAlias);
+			if (!font)
+			{
+				std::promise<std::size_t> none;
+				none.set_value(0);
+				return none.get_future();
+			}
+			characterSizes[fontAlias].insert(sizes.cbegin(), sizes.cend());
+			return pool.enqueue([font, sizes, charset, bold]
+			{
+				return rasterize(*font, sizes, charset, bold);
+			});
+		}
 	};
 }
\ No newline at end of file
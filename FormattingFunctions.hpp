@@ -2,12 +2,15 @@
 
 #include <iostream>
 #include <string>
+#include <list>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <cstdio>
 
 namespace ash
 {
-	std::string convertToLowerCase(const std::string & str)
+	inline std::string convertToLowerCase(const std::string & str)
 	{
 		std::string result;
 		for (char i : str)
@@ -17,7 +20,7 @@ namespace ash
 		return result;
 	}
 
-	std::string convertToUpperCase(const std::string & str)
+	inline std::string convertToUpperCase(const std::string & str)
 	{
 		std::string result;
 		for (char i : str)
@@ -27,7 +30,7 @@ namespace ash
 		return result;
 	}
 
-	std::string removePunctuation(const std::string & str)
+	inline std::string removePunctuation(const std::string & str)
 	{
 		std::string result;
 		for (char i : str)
@@ -40,7 +43,7 @@ namespace ash
 		return result;
 	}
 
-	std::string removeSpaces(const std::string & str)
+	inline std::string removeSpaces(const std::string & str)
 	{
 		std::string result;
 		for (char i : str)
@@ -53,7 +56,7 @@ namespace ash
 		return result;
 	}
 
-	std::string removeLeadingSpaces(const std::string & str)
+	inline std::string removeLeadingSpaces(const std::string & str)
 	{
 		for (unsigned int i = 0; i < str.size(); ++i)
 		{
@@ -65,7 +68,7 @@ namespace ash
 		return "";
 	}
 
-	std::string removeCharacter(const std::string & str, char ch)
+	inline std::string removeCharacter(const std::string & str, char ch)
 	{
 		std::string result;
 		for (char i : str)
@@ -78,7 +81,7 @@ namespace ash
 		return result;
 	}
 
-	std::string replaceCharacter(const std::string & str, char remove, char replace)
+	inline std::string replaceCharacter(const std::string & str, char remove, char replace)
 	{
 		std::string result(str.cbegin(), str.cend());
 		for (char & i : result)
@@ -91,7 +94,7 @@ namespace ash
 		return result;
 	}
 
-	std::string invertCase(const std::string & str)
+	inline std::string invertCase(const std::string & str)
 	{
 		std::string result;
 		for (char i : str)
@@ -115,22 +118,22 @@ namespace ash
 		return result;
 	}
 
-	std::string reverse(const std::string & str)
+	inline std::string reverse(const std::string & str)
 	{
 		return std::string(str.crbegin(), str.crend());
 	}
 
-	std::string removeTrailingSpaces(const std::string & str)
+	inline std::string removeTrailingSpaces(const std::string & str)
 	{
 		return reverse(removeLeadingSpaces(reverse(str)));
 	}
 
-	bool startsWithCharacter(const std::string & str, char ch)
+	inline bool startsWithCharacter(const std::string & str, char ch)
 	{
 		return str.size() > 0 && str.at(0) == ch;
 	}
 
-	bool firstNonWhiteSpaceCharacterIs(const std::string & str, char ch)
+	inline bool firstNonWhiteSpaceCharacterIs(const std::string & str, char ch)
 	{
 		for (char i : str)
 		{
@@ -142,7 +145,7 @@ namespace ash
 		return false;
 	}
 
-	bool lengthIs(const std::string & str, std::size_t length)
+	inline bool lengthIs(const std::string & str, std::size_t length)
 	{
 		return str.size() == length;
 	}
@@ -160,7 +163,7 @@ namespace ash
 		}
 		return result;
 	}
-	std::string inflateList(const std::list<std::string> & list, const std::string & separator = ", ")
+	inline std::string inflateList(const std::list<std::string> & list, const std::string & separator = ", ")
 	{
 		std::string result = std::accumulate(list.cbegin(), list.cend(), std::string(), [separator](const std::string & current, const std::string & val)
 		{
@@ -173,7 +176,7 @@ namespace ash
 		return result;
 	}
 
-	std::list<std::string> splitString(const std::string & str, char separator = ',')
+	inline std::list<std::string> splitString(const std::string & str, char separator = ',')
 	{
 		std::list<std::string> result;
 		std::string::const_iterator iterator = str.cbegin();
@@ -197,4 +200,70 @@ namespace ash
 		}
 		return result;
 	}
+
+	// Large enough for anything formatInteger or formatDecimal write, terminating null included
+	const std::size_t NUMBER_BUFFER_SIZE = 32;
+
+	inline std::size_t formatInteger(char * buffer, long long val)
+	{
+		// Writes 'val' into 'buffer' without allocating and returns the number of characters written, not counting the terminating null
+		unsigned long long magnitude = val < 0 ? 0ull - static_cast<unsigned long long>(val) : static_cast<unsigned long long>(val);
+		char digits[20];
+		std::size_t count = 0;
+		do
+		{
+			digits[count++] = static_cast<char>('0' + magnitude % 10);
+			magnitude /= 10;
+		} while (magnitude);
+		std::size_t length = 0;
+		if (val < 0)
+		{
+			buffer[length++] = '-';
+		}
+		while (count)
+		{
+			buffer[length++] = digits[--count];
+		}
+		buffer[length] = '\0';
+		return length;
+	}
+
+	inline std::size_t formatDecimal(char * buffer, double val, unsigned int precision = 6)
+	{
+		// Fixed notation with 'precision' decimals (at most 9), like std::to_string for the default of 6, without allocating
+		// Ties round away from zero and rounding is done in double precision, so the last digit can differ from printf's
+		const double scales[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+		precision = std::min(precision, 9u);
+		double scaled = std::fabs(val) * scales[precision] + .5;
+		if (!(scaled < 9.2e18))
+		{
+			// Infinities, NaN and values too large for the fixed point integer: printf's fixed notation if it fits, scientific otherwise
+			int length = std::snprintf(buffer, NUMBER_BUFFER_SIZE, "%.*f", static_cast<int>(precision), val);
+			if (length < 0 || static_cast<std::size_t>(length) >= NUMBER_BUFFER_SIZE)
+			{
+				length = std::snprintf(buffer, NUMBER_BUFFER_SIZE, "%.*g", static_cast<int>(precision), val);
+			}
+			return static_cast<std::size_t>(std::max(length, 0));
+		}
+		unsigned long long fixed = static_cast<unsigned long long>(scaled);
+		unsigned long long divisor = static_cast<unsigned long long>(scales[precision]);
+		std::size_t length = 0;
+		if (std::signbit(val))
+		{
+			buffer[length++] = '-';
+		}
+		length += formatInteger(buffer + length, static_cast<long long>(fixed / divisor));
+		if (precision)
+		{
+			unsigned long long fraction = fixed % divisor;
+			buffer[length++] = '.';
+			for (std::size_t i = length + precision; i > length; fraction /= 10)
+			{
+				buffer[--i] = static_cast<char>('0' + fraction % 10);
+			}
+			length += precision;
+		}
+		buffer[length] = '\0';
+		return length;
+	}
 }
\ No newline at end of file
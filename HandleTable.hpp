@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace sfext
+{
+	struct ResourceHandle
+	{
+		std::uint32_t index;
+		std::uint32_t generation; // Never 0 for a handle that was issued, so a default handle is always invalid
+		ResourceHandle() : index(0), generation(0)
+		{
+		}
+		ResourceHandle(std::uint32_t i, std::uint32_t gen) : index(i), generation(gen)
+		{
+		}
+		bool isValid() const
+		{
+			return generation != 0;
+		}
+		bool operator ==(const ResourceHandle & rhs) const
+		{
+			return index == rhs.index && generation == rhs.generation;
+		}
+		bool operator !=(const ResourceHandle & rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	template <class T>
+	class HandleTable final
+	{
+	private:
+		struct Slot
+		{
+			T             value;
+			std::uint32_t generation;
+			bool          occupied;
+		};
+		std::vector<Slot>          slots;
+		std::vector<std::uint32_t> freeSlots;
+		std::size_t                count;
+	public:
+		// Constructors
+		HandleTable() : count(0)
+		{
+		}
+		HandleTable(const HandleTable & rhs) : slots(rhs.slots), freeSlots(rhs.freeSlots), count(rhs.count)
+		{
+		}
+		// Destructor
+		~HandleTable()
+		{
+		}
+		// Assignment
+		HandleTable & operator =(const HandleTable & rhs)
+		{
+			slots = rhs.slots;
+			freeSlots = rhs.freeSlots;
+			count = rhs.count;
+			return *this;
+		}
+		// Accessors
+		T *         get     (const ResourceHandle & handle)
+		{
+			return contains(handle) ? &slots[handle.index].value : nullptr;
+		}
+		const T *   get     (const ResourceHandle & handle) const
+		{
+			return contains(handle) ? &slots[handle.index].value : nullptr;
+		}
+		T *         getAt   (std::uint32_t index)
+		{
+			// Unchecked against generations; for owners walking their own slots
+			return index < slots.size() && slots[index].occupied ? &slots[index].value : nullptr;
+		}
+		const T *   getAt   (std::uint32_t index) const
+		{
+			return index < slots.size() && slots[index].occupied ? &slots[index].value : nullptr;
+		}
+		std::size_t size    () const
+		{
+			return count;
+		}
+		std::size_t capacity() const
+		{
+			// One past the highest slot index ever issued
+			return slots.size();
+		}
+		// Utilities
+		ResourceHandle insert  (const T & value)
+		{
+			// Reuses a freed slot when possible; its generation was bumped on erase so old handles stay invalid
+			std::uint32_t index;
+			if (!freeSlots.empty())
+			{
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+			else
+			{
+				index = static_cast<std::uint32_t>(slots.size());
+				Slot slot = { T(), 1, false };
+				slots.push_back(slot);
+			}
+			slots[index].value = value;
+			slots[index].occupied = true;
+			++count;
+			return ResourceHandle(index, slots[index].generation);
+		}
+		bool           contains(const ResourceHandle & handle) const
+		{
+			return handle.index < slots.size() && slots[handle.index].occupied && slots[handle.index].generation == handle.generation;
+		}
+		bool           erase   (const ResourceHandle & handle)
+		{
+			if (contains(handle))
+			{
+				Slot & slot = slots[handle.index];
+				slot.value = T();
+				slot.occupied = false;
+				slot.generation = (slot.generation + 1 ? slot.generation + 1 : 1);
+				freeSlots.push_back(handle.index);
+				--count;
+				return true;
+			}
+			return false;
+		}
+		void           clear   ()
+		{
+			for (std::uint32_t i = 0; i < slots.size(); ++i)
+			{
+				erase(ResourceHandle(i, slots[i].generation));
+			}
+		}
+	};
+}
\ No newline at end of file
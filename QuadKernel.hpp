@@ -0,0 +1,263 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdlib>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFEXT_QUADKERNEL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace sfext
+{
+	// One stream per attribute so the kernel can load several instances at once
+	struct QuadStreams
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> width;
+		std::vector<float> height;
+		std::vector<float> u;
+		std::vector<float> v;
+		std::vector<float> uWidth;
+		std::vector<float> vHeight;
+		std::vector<float> rotation; // Radians around the quad's top left corner; leave empty for axis-aligned quads
+		std::vector<float> scaleX;   // Leave both scale streams empty for unscaled quads
+		std::vector<float> scaleY;
+		std::size_t size() const
+		{
+			return x.size();
+		}
+		void clear()
+		{
+			x.clear();
+			y.clear();
+			width.clear();
+			height.clear();
+			u.clear();
+			v.clear();
+			uWidth.clear();
+			vHeight.clear();
+			rotation.clear();
+			scaleX.clear();
+			scaleY.clear();
+		}
+		void append(const sf::Vector2f & position, const sf::IntRect & rectangle)
+		{
+			// The quad's size matches its texture rectangle, as with an untransformed sprite; a negative size only flips the texture
+			x.push_back(position.x);
+			y.push_back(position.y);
+			width.push_back(static_cast<float>(std::abs(rectangle.width)));
+			height.push_back(static_cast<float>(std::abs(rectangle.height)));
+			u.push_back(static_cast<float>(rectangle.left));
+			v.push_back(static_cast<float>(rectangle.top));
+			uWidth.push_back(static_cast<float>(rectangle.width));
+			vHeight.push_back(static_cast<float>(rectangle.height));
+		}
+		void append(const sf::Vector2f & position, const sf::IntRect & rectangle, float radians, const sf::Vector2f & scale)
+		{
+			append(position, rectangle);
+			rotation.push_back(radians);
+			scaleX.push_back(scale.x);
+			scaleY.push_back(scale.y);
+		}
+		bool isValid() const
+		{
+			// Optional streams are either empty or as long as the required ones
+			std::size_t count = x.size();
+			return y.size() == count && width.size() == count && height.size() == count && u.size() == count && v.size() == count && uWidth.size() == count && vHeight.size() == count
+				&& (rotation.empty() || rotation.size() == count) && scaleX.size() == scaleY.size() && (scaleX.empty() || scaleX.size() == count);
+		}
+	};
+
+	// Writes quads [first, last) of 'quads' into 'vertices', four vertices per quad; colours are left untouched
+	inline void expandQuadsScalar(const QuadStreams & quads, sf::Vertex * vertices, std::size_t first, std::size_t last)
+	{
+		bool rotated = !quads.rotation.empty();
+		bool scaled = !quads.scaleX.empty();
+		for (std::size_t i = first; i < last; ++i)
+		{
+			float width = quads.width[i];
+			float height = quads.height[i];
+			if (scaled)
+			{
+				width *= quads.scaleX[i];
+				height *= quads.scaleY[i];
+			}
+			// Offsets from the top left corner to the top right (a) and bottom left (b) corners
+			float ax = width, ay = 0.f, bx = 0.f, by = height;
+			if (rotated)
+			{
+				float cosine = std::cos(quads.rotation[i]);
+				float sine = std::sin(quads.rotation[i]);
+				ax = width * cosine;
+				ay = width * sine;
+				bx = -(height * sine);
+				by = height * cosine;
+			}
+			float x = quads.x[i];
+			float y = quads.y[i];
+			float u = quads.u[i];
+			float v = quads.v[i];
+			float u1 = u + quads.uWidth[i];
+			float v1 = v + quads.vHeight[i];
+			sf::Vertex * quad = vertices + i * 4;
+			quad[0].position = sf::Vector2f(x, y);
+			quad[1].position = sf::Vector2f(x + ax, y + ay);
+			quad[2].position = sf::Vector2f((x + ax) + bx, (y + ay) + by);
+			quad[3].position = sf::Vector2f(x + bx, y + by);
+			quad[0].texCoords = sf::Vector2f(u, v);
+			quad[1].texCoords = sf::Vector2f(u1, v);
+			quad[2].texCoords = sf::Vector2f(u1, v1);
+			quad[3].texCoords = sf::Vector2f(u, v1);
+		}
+	}
+
+	inline bool hasQuadKernelSimd()
+	{
+#ifdef SFEXT_QUADKERNEL_SSE
+		return true;
+#else
+		return false;
+#endif
+	}
+
+#ifdef SFEXT_QUADKERNEL_SSE
+	// Stores the (x, y) pair held in the low or high half of 'pairs' into 'target'
+	inline void storeLowPair(sf::Vector2f & target, __m128 pairs)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64 *>(&target), pairs);
+	}
+
+	inline void storeHighPair(sf::Vector2f & target, __m128 pairs)
+	{
+		_mm_storeh_pi(reinterpret_cast<__m64 *>(&target), pairs);
+	}
+
+	// Sine and cosine of four angles at once, within about 1e-7 of std::sin and std::cos for |radians| up to 8192; larger angles
+	// lose precision in the range reduction, so expandQuads hands blocks containing them to std::sin and std::cos
+	inline void sinCos4(__m128 radians, __m128 & sine, __m128 & cosine)
+	{
+		// Reduces to [-pi/4, pi/4] around the nearest even multiple of pi/4 (Cody-Waite, in three parts), evaluates the sine and
+		// cosine polynomials there and picks and signs them by octant
+		const __m128 signBit = _mm_set1_ps(-0.f);
+		__m128 x = _mm_andnot_ps(signBit, radians);
+		__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 multiple = _mm_cvtepi32_ps(octant);
+		x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(3.77489497744594108e-8f)));
+		__m128 sineSign = _mm_xor_ps(_mm_and_ps(radians, signBit), _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)));
+		__m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		__m128 swapped = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+		__m128 z = _mm_mul_ps(x, x);
+		__m128 cosinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+		cosinePolynomial = _mm_add_ps(_mm_mul_ps(cosinePolynomial, z), _mm_set1_ps(4.166664568298827e-2f));
+		cosinePolynomial = _mm_mul_ps(_mm_mul_ps(cosinePolynomial, z), z);
+		cosinePolynomial = _mm_add_ps(_mm_sub_ps(cosinePolynomial, _mm_mul_ps(z, _mm_set1_ps(.5f))), _mm_set1_ps(1.f));
+		__m128 sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+		sinePolynomial = _mm_add_ps(_mm_mul_ps(sinePolynomial, z), _mm_set1_ps(-1.6666654611e-1f));
+		sinePolynomial = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinePolynomial, z), x), x);
+		sine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swapped, cosinePolynomial), _mm_andnot_ps(swapped, sinePolynomial)), sineSign);
+		cosine = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swapped, sinePolynomial), _mm_andnot_ps(swapped, cosinePolynomial)), cosineSign);
+	}
+#endif
+
+	// Writes quads [first, last) of 'quads' into 'vertices', four vertices per quad; colours are left untouched
+	inline void expandQuads(const QuadStreams & quads, sf::Vertex * vertices, std::size_t first, std::size_t last)
+	{
+		std::size_t i = first;
+#ifdef SFEXT_QUADKERNEL_SSE
+		// Axis-aligned quads are bound by the vertex stores, which the scalar loop keeps as busy, so only rotated streams take this
+		// path: four instances per iteration, with their sines and cosines from one sinCos4 instead of eight library calls
+		if (!quads.rotation.empty())
+		{
+			bool scaled = !quads.scaleX.empty();
+			const __m128 largeAngle = _mm_set1_ps(8192.f);
+			alignas(16) float cosines[4];
+			alignas(16) float sines[4];
+			for (; i + 4 <= last; i += 4)
+			{
+				__m128 width = _mm_loadu_ps(&quads.width[i]);
+				__m128 height = _mm_loadu_ps(&quads.height[i]);
+				if (scaled)
+				{
+					width = _mm_mul_ps(width, _mm_loadu_ps(&quads.scaleX[i]));
+					height = _mm_mul_ps(height, _mm_loadu_ps(&quads.scaleY[i]));
+				}
+				__m128 radians = _mm_loadu_ps(&quads.rotation[i]);
+				__m128 sine;
+				__m128 cosine;
+				if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), radians), largeAngle)) == 0)
+				{
+					sinCos4(radians, sine, cosine);
+				}
+				else
+				{
+					for (std::size_t j = 0; j < 4; ++j)
+					{
+						cosines[j] = std::cos(quads.rotation[i + j]);
+						sines[j] = std::sin(quads.rotation[i + j]);
+					}
+					cosine = _mm_load_ps(cosines);
+					sine = _mm_load_ps(sines);
+				}
+				__m128 ax = _mm_mul_ps(width, cosine);
+				__m128 ay = _mm_mul_ps(width, sine);
+				__m128 bx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(height, sine));
+				__m128 by = _mm_mul_ps(height, cosine);
+				__m128 x = _mm_loadu_ps(&quads.x[i]);
+				__m128 y = _mm_loadu_ps(&quads.y[i]);
+				__m128 u = _mm_loadu_ps(&quads.u[i]);
+				__m128 v = _mm_loadu_ps(&quads.v[i]);
+				__m128 xa = _mm_add_ps(x, ax);
+				__m128 ya = _mm_add_ps(y, ay);
+				__m128 u1 = _mm_add_ps(u, _mm_loadu_ps(&quads.uWidth[i]));
+				__m128 v1 = _mm_add_ps(v, _mm_loadu_ps(&quads.vHeight[i]));
+				// sf::Vertex interleaves position, colour and texture coordinates, so (x, y) pairs are interleaved in registers
+				// (instances 0 and 1 in the low pairs, 2 and 3 in the high ones) and stored in memory order, two floats at a time
+				__m128 positions[2][4] =
+				{
+					{ _mm_unpacklo_ps(x, y), _mm_unpacklo_ps(xa, ya), _mm_unpacklo_ps(_mm_add_ps(xa, bx), _mm_add_ps(ya, by)), _mm_unpacklo_ps(_mm_add_ps(x, bx), _mm_add_ps(y, by)) },
+					{ _mm_unpackhi_ps(x, y), _mm_unpackhi_ps(xa, ya), _mm_unpackhi_ps(_mm_add_ps(xa, bx), _mm_add_ps(ya, by)), _mm_unpackhi_ps(_mm_add_ps(x, bx), _mm_add_ps(y, by)) }
+				};
+				__m128 texCoords[2][4] =
+				{
+					{ _mm_unpacklo_ps(u, v), _mm_unpacklo_ps(u1, v), _mm_unpacklo_ps(u1, v1), _mm_unpacklo_ps(u, v1) },
+					{ _mm_unpackhi_ps(u, v), _mm_unpackhi_ps(u1, v), _mm_unpackhi_ps(u1, v1), _mm_unpackhi_ps(u, v1) }
+				};
+				sf::Vertex * quad = vertices + i * 4;
+				for (std::size_t half = 0; half < 2; ++half, quad += 8)
+				{
+					for (std::size_t corner = 0; corner < 4; ++corner)
+					{
+						storeLowPair(quad[corner].position, positions[half][corner]);
+						storeLowPair(quad[corner].texCoords, texCoords[half][corner]);
+					}
+					for (std::size_t corner = 0; corner < 4; ++corner)
+					{
+						storeHighPair(quad[4 + corner].position, positions[half][corner]);
+						storeHighPair(quad[4 + corner].texCoords, texCoords[half][corner]);
+					}
+				}
+			}
+		}
+#endif
+		expandQuadsScalar(quads, vertices, i, last);
+	}
+
+	// Writes every quad in 'quads' into 'vertices', which must hold quads.size() * 4 vertices
+	inline void expandQuads(const QuadStreams & quads, sf::Vertex * vertices)
+	{
+		// Checked once here rather than per range, as the parallel batch paths call the range overload many times per batch
+		assert(("Every quad stream must have the same length", quads.isValid()));
+		expandQuads(quads, vertices, 0, quads.size());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "SpriteBatch.hpp"
+#include "SpriteHandler.hpp"
+
+namespace sfext
+{
+	struct RenderQueueStats
+	{
+		std::size_t submitted;
+		std::size_t drawCalls;
+		std::size_t stateChanges; // Texture binds, the first one included, plus blend mode switches between draws
+	};
+
+	class RenderQueue final
+	{
+	private:
+		struct Item
+		{
+			sf::Vector2f  position;
+			sf::IntRect   rectangle;
+			sf::Color     color;
+			std::uint64_t key; // Depth in the high 32 bits, then the texture index in 24 bits and the blend mode index in the low 8
+		};
+		std::vector<Item>                items;
+		std::vector<const sf::Texture *> textures; // Textures seen since the last flush, indexed by the key's texture bits
+		std::vector<sf::BlendMode>       blendModes; // Likewise for the blend modes
+		static const std::size_t         RADIX_SORT_THRESHOLD = 1024; // Smaller queues are sorted with std::sort
+		std::vector<std::uint32_t>       order;
+		std::vector<std::uint32_t>       scratch;
+		std::vector<std::uint32_t>       counts;
+		std::vector<sf::Vertex>          vertices;
+		RenderQueueStats                 stats;
+		std::uint32_t textureIndex(const sf::Texture * texture)
+		{
+			// Frames use few distinct textures, and consecutive submits usually share one
+			if (!textures.empty() && textures.back() == texture)
+			{
+				return static_cast<std::uint32_t>(textures.size() - 1);
+			}
+			for (std::uint32_t i = 0; i < textures.size(); ++i)
+			{
+				if (textures[i] == texture)
+				{
+					return i;
+				}
+			}
+			assert(("Too many textures in one flush", textures.size() < (1u << 24)));
+			textures.push_back(texture);
+			return static_cast<std::uint32_t>(textures.size() - 1);
+		}
+		std::uint32_t blendModeIndex(const sf::BlendMode & blendMode)
+		{
+			for (std::uint32_t i = 0; i < blendModes.size(); ++i)
+			{
+				if (blendModes[i] == blendMode)
+				{
+					return i;
+				}
+			}
+			assert(("Too many blend modes in one flush", blendModes.size() < 256));
+			blendModes.push_back(blendMode);
+			return static_cast<std::uint32_t>(blendModes.size() - 1);
+		}
+		const sf::Texture *   textureOf  (const Item & item) const
+		{
+			return textures[(item.key >> 8) & 0xFFFFFFu];
+		}
+		const sf::BlendMode & blendModeOf(const Item & item) const
+		{
+			return blendModes[item.key & 0xFFu];
+		}
+		static std::uint32_t sortableDepth(float depth)
+		{
+			// Maps IEEE floats to unsigned integers with the same ordering
+			std::uint32_t bits;
+			std::memcpy(&bits, &depth, sizeof(bits));
+			return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+		}
+		void sort()
+		{
+			// Stable LSD radix sort on 16-bit digits; passes where every key shares the digit are skipped
+			// Each pass clears and scans all 65536 counts, so small queues use a comparison sort, tied on submission order instead
+			order.resize(items.size());
+			scratch.resize(items.size());
+			for (std::uint32_t i = 0; i < order.size(); ++i)
+			{
+				order[i] = i;
+			}
+			if (items.size() < RADIX_SORT_THRESHOLD)
+			{
+				std::sort(order.begin(), order.end(), [this](std::uint32_t lhs, std::uint32_t rhs)
+				{
+					return items[lhs].key < items[rhs].key || (items[lhs].key == items[rhs].key && lhs < rhs);
+				});
+				return;
+			}
+			counts.resize(65536);
+			for (unsigned int shift = 0; shift < 64; shift += 16)
+			{
+				std::fill(counts.begin(), counts.end(), 0);
+				for (const Item & item : items)
+				{
+					++counts[(item.key >> shift) & 0xFFFF];
+				}
+				if (counts[(items[0].key >> shift) & 0xFFFF] == items.size())
+				{
+					continue;
+				}
+				std::uint32_t total = 0;
+				for (std::uint32_t & count : counts)
+				{
+					std::uint32_t current = count;
+					count = total;
+					total += current;
+				}
+				for (std::uint32_t index : order)
+				{
+					scratch[counts[(items[index].key >> shift) & 0xFFFF]++] = index;
+				}
+				order.swap(scratch);
+			}
+		}
+	public:
+		// Constructors
+		RenderQueue()
+		{
+			stats.submitted = 0;
+			stats.drawCalls = 0;
+			stats.stateChanges = 0;
+		}
+		RenderQueue(const RenderQueue & rhs) : items(rhs.items), textures(rhs.textures), blendModes(rhs.blendModes), stats(rhs.stats)
+		{
+		}
+		// Destructor
+		~RenderQueue()
+		{
+		}
+		// Accessors
+		std::size_t                     getSize    () const
+		{
+			// Items submitted since the last flush
+			return items.size();
+		}
+		const RenderQueueStats &        getStats   () const
+		{
+			// Counters for the last flush
+			return stats;
+		}
+		const std::vector<sf::Vertex> & getVertices() const
+		{
+			// The quads of the last flush, in the order they were drawn
+			return vertices;
+		}
+		// Utilities
+		void submit(const sf::Texture * texture, const sf::Vector2f & position, const sf::IntRect & rectangle, const sf::Color & color = sf::Color::White, float depth = 0.f, const sf::BlendMode & blendMode = sf::BlendAlpha)
+		{
+			// Lower depths are drawn first; equal depths are grouped by texture, then blend mode, and keep submission order within a group
+			Item item = { position, rectangle, color, (static_cast<std::uint64_t>(sortableDepth(depth)) << 32) | (static_cast<std::uint64_t>(textureIndex(texture)) << 8) | blendModeIndex(blendMode) };
+			items.push_back(item);
+		}
+		void submit(SpriteHandler & sprites, const ResourceHandle & handle, const sf::Vector2f & position, const sf::IntRect & rectangle, const sf::Color & color = sf::Color::White, float depth = 0.f, const sf::BlendMode & blendMode = sf::BlendAlpha)
+		{
+			// Counts as a use of the texture; keep the sprite handler's budget from evicting it before flush() (see TextureHandler::getTexture)
+			if (sprites.hasTexture(handle))
+			{
+				submit(&sprites.getTexture(handle), position, rectangle, color, depth, blendMode);
+			}
+		}
+		void submit(SpriteHandler & sprites, const sf::String & alias, const sf::Vector2f & position, const sf::IntRect & rectangle, const sf::Color & color = sf::Color::White, float depth = 0.f, const sf::BlendMode & blendMode = sf::BlendAlpha)
+		{
+			submit(sprites, sprites.getHandle(alias), position, rectangle, color, depth, blendMode);
+		}
+		void flush (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Sorts by depth, texture then blend mode and issues one draw per run of quads sharing both; 'states' supplies the transform and shader
+			stats.submitted = items.size();
+			stats.drawCalls = 0;
+			stats.stateChanges = 0;
+			if (!items.empty())
+			{
+				sort();
+				vertices.resize(items.size() * 4);
+				for (std::size_t i = 0; i < order.size(); ++i)
+				{
+					const Item & item = items[order[i]];
+					sf::Vertex * quad = &vertices[i * 4];
+					SpriteBatch::writeQuad(quad, item.position, item.rectangle);
+					quad[0].color = quad[1].color = quad[2].color = quad[3].color = item.color;
+				}
+				std::size_t runStart = 0;
+				for (std::size_t i = 1; i <= order.size(); ++i)
+				{
+					const Item & run = items[order[runStart]];
+					if (i == order.size() || textureOf(items[order[i]]) != textureOf(run) || blendModeOf(items[order[i]]) != blendModeOf(run))
+					{
+						// A run can end on either change; only what actually differs from the previous draw counts
+						if (!stats.drawCalls || textureOf(run) != states.texture)
+						{
+							++stats.stateChanges;
+						}
+						if (stats.drawCalls && blendModeOf(run) != states.blendMode)
+						{
+							++stats.stateChanges;
+						}
+						states.texture = textureOf(run);
+						states.blendMode = blendModeOf(run);
+						target.draw(&vertices[runStart * 4], (i - runStart) * 4, sf::Quads, states);
+						++stats.drawCalls;
+						runStart = i;
+					}
+				}
+			}
+			clear();
+		}
+		void clear ()
+		{
+			items.clear();
+			textures.clear();
+			blendModes.clear();
+		}
+	};
+}
\ No newline at end of file
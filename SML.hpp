@@ -108,10 +108,27 @@ namespace ash
 			return result;
 		}
 		// Mutators
-		void setTargetFile(const sf::String & filePath)
+		void setTargetFile (const sf::String & filePath)
 		{
 			file.setFileName(filePath);
 		}
+		void setValue      (const sf::String & variable, const sf::String & tag, const sf::String & value)
+		{
+			values[variable][tag] = value;
+		}
+		bool removeTag     (const sf::String & variable, const sf::String & tag)
+		{
+			if (hasTag(variable, tag))
+			{
+				values.at(variable).erase(tag);
+				return true;
+			}
+			return false;
+		}
+		bool removeVariable(const sf::String & variable)
+		{
+			return values.erase(variable) != 0;
+		}
 		// Utilities
 		void parseValues()
 		{
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <functional>
+
+#include "SML.hpp"
+
+#include <SFML/System/String.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Vector3.hpp>
+#include <SFML/Graphics/Color.hpp>
+
+namespace ash
+{
+	template <class T>
+	class SMLSchema final
+	{
+	private:
+		struct Field
+		{
+			sf::String variable;
+			sf::String tag;
+			bool       required;
+			std::function<bool(const std::string &, T &)> parse; // Returns false if the value has the wrong type
+			std::function<void(T &)>                      applyDefault;
+		};
+		std::vector<Field> fields;
+		bool               strict;
+		// Parsing helpers
+		static bool parseNumber(const std::string & str, double & result)
+		{
+			std::string trimmed = removeTrailingSpaces(removeLeadingSpaces(str));
+			if (trimmed.empty())
+			{
+				return false;
+			}
+			char * end = nullptr;
+			result = std::strtod(trimmed.c_str(), &end);
+			return end == trimmed.c_str() + trimmed.size();
+		}
+		static bool parseNumbers(const std::string & str, std::vector<double> & result, std::size_t count)
+		{
+			std::list<std::string> split = splitString(str);
+			if (split.size() != count)
+			{
+				return false;
+			}
+			result.clear();
+			for (const std::string & element : split)
+			{
+				double value = 0.0;
+				if (!parseNumber(element, value))
+				{
+					return false;
+				}
+				result.push_back(value);
+			}
+			return true;
+		}
+		template <class U>
+		static bool convertNumber(double value, U & result)
+		{
+			// Rejects what static_cast would truncate or could not represent: fractions and out of range values for integers, overflow for floating point
+			if (std::is_integral<U>::value)
+			{
+				if (value != std::floor(value) || value < static_cast<double>(std::numeric_limits<U>::min()) || value >= std::ldexp(1.0, std::numeric_limits<U>::digits))
+				{
+					return false;
+				}
+			}
+			else if (std::fabs(value) > static_cast<double>(std::numeric_limits<U>::max()))
+			{
+				return false;
+			}
+			result = static_cast<U>(value);
+			return true;
+		}
+		SMLSchema & addField(const sf::String & variable, const sf::String & tag, bool required, const std::function<bool(const std::string &, T &)> & parse, const std::function<void(T &)> & applyDefault)
+		{
+			Field field;
+			field.variable = variable;
+			field.tag = tag;
+			field.required = required;
+			field.parse = parse;
+			field.applyDefault = applyDefault;
+			fields.push_back(field);
+			return *this;
+		}
+	public:
+		// Constructors
+		SMLSchema() : strict(false)
+		{
+		}
+		SMLSchema(const SMLSchema & rhs) : fields(rhs.fields), strict(rhs.strict)
+		{
+		}
+		// Destructor
+		~SMLSchema()
+		{
+		}
+		// Accessors
+		std::size_t getFieldCount() const
+		{
+			return fields.size();
+		}
+		bool        isStrict     () const
+		{
+			return strict;
+		}
+		// Mutators
+		void setStrict(bool strictness)
+		{
+			// When strict, tags found in a bound variable that no field refers to are reported as errors (catches typos in the file)
+			strict = strictness;
+		}
+		// Bindings
+		template <class U>
+		SMLSchema & bindNumber (const sf::String & variable, const sf::String & tag, U T::* member, U defaultValue = U(), bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				double value = 0.0;
+				U result;
+				if (!parseNumber(str, value) || !convertNumber(value, result))
+				{
+					return false;
+				}
+				target.*member = result;
+				return true;
+			}, [member, defaultValue](T & target)
+			{
+				target.*member = defaultValue;
+			});
+		}
+		template <class U>
+		SMLSchema & bindVector2(const sf::String & variable, const sf::String & tag, sf::Vector2<U> T::* member, const sf::Vector2<U> & defaultValue = sf::Vector2<U>(), bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				std::vector<double> values;
+				sf::Vector2<U> result;
+				if (!parseNumbers(str, values, 2) || !convertNumber(values[0], result.x) || !convertNumber(values[1], result.y))
+				{
+					return false;
+				}
+				target.*member = result;
+				return true;
+			}, [member, defaultValue](T & target)
+			{
+				target.*member = defaultValue;
+			});
+		}
+		template <class U>
+		SMLSchema & bindVector3(const sf::String & variable, const sf::String & tag, sf::Vector3<U> T::* member, const sf::Vector3<U> & defaultValue = sf::Vector3<U>(), bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				std::vector<double> values;
+				sf::Vector3<U> result;
+				if (!parseNumbers(str, values, 3) || !convertNumber(values[0], result.x) || !convertNumber(values[1], result.y) || !convertNumber(values[2], result.z))
+				{
+					return false;
+				}
+				target.*member = result;
+				return true;
+			}, [member, defaultValue](T & target)
+			{
+				target.*member = defaultValue;
+			});
+		}
+		SMLSchema & bindColor  (const sf::String & variable, const sf::String & tag, sf::Color T::* member, const sf::Color & defaultValue = sf::Color::White, bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				// Matches SML::interpretAsColor: alpha may be omitted
+				std::vector<double> values;
+				if (!parseNumbers(str, values, 4))
+				{
+					if (!parseNumbers(str, values, 3))
+					{
+						return false;
+					}
+					values.push_back(255.0);
+				}
+				for (double value : values)
+				{
+					if (value < 0.0 || value > 255.0)
+					{
+						return false;
+					}
+				}
+				target.*member = sf::Color(static_cast<sf::Uint8>(values[0]), static_cast<sf::Uint8>(values[1]), static_cast<sf::Uint8>(values[2]), static_cast<sf::Uint8>(values[3]));
+				return true;
+			}, [member, defaultValue](T & target)
+			{
+				target.*member = defaultValue;
+			});
+		}
+		SMLSchema & bindString (const sf::String & variable, const sf::String & tag, sf::String T::* member, const sf::String & defaultValue = sf::String(), bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				target.*member = str;
+				return true;
+			}, [member, defaultValue](T & target)
+			{
+				target.*member = defaultValue;
+			});
+		}
+		template <class U>
+		SMLSchema & bindList   (const sf::String & variable, const sf::String & tag, std::list<U> T::* member, bool required = false)
+		{
+			return addField(variable, tag, required, [member](const std::string & str, T & target)
+			{
+				std::vector<double> values;
+				if (!parseNumbers(str, values, splitString(str).size()))
+				{
+					return false;
+				}
+				std::list<U> result;
+				for (double value : values)
+				{
+					U element;
+					if (!convertNumber(value, element))
+					{
+						return false;
+					}
+					result.push_back(element);
+				}
+				(target.*member).swap(result);
+				return true;
+			}, [member](T & target)
+			{
+				(target.*member).clear();
+			});
+		}
+		// Utilities
+		bool load(const SML & sml, T & target, std::vector<std::string> * errors = nullptr) const
+		{
+			// Fills 'target' once so that hot code can read plain struct fields; returns false if anything failed validation
+			bool valid = true;
+			auto report = [&valid, errors](const std::string & message)
+			{
+				valid = false;
+				if (errors)
+				{
+					errors->push_back(message);
+				}
+			};
+			std::map<sf::String, std::set<sf::String>> boundTags;
+			for (const Field & field : fields)
+			{
+				boundTags[field.variable].insert(field.tag);
+				std::string name = field.variable.toAnsiString() + "." + field.tag.toAnsiString();
+				if (!sml.hasTag(field.variable, field.tag))
+				{
+					field.applyDefault(target);
+					if (field.required)
+					{
+						report(name + " is required but missing");
+					}
+				}
+				else if (!field.parse(sml.getValue(field.variable, field.tag), target))
+				{
+					field.applyDefault(target);
+					report(name + " has an invalid value \"" + sml.getValue(field.variable, field.tag).toAnsiString() + "\"");
+				}
+			}
+			if (strict)
+			{
+				for (const auto & variable : boundTags)
+				{
+					for (const sf::String & tag : sml.getTags(variable.first))
+					{
+						if (variable.second.find(tag) == variable.second.cend())
+						{
+							report(variable.first.toAnsiString() + "." + tag.toAnsiString() + " is not part of the schema");
+						}
+					}
+				}
+			}
+			return valid;
+		}
+	};
+}
\ No newline at end of file
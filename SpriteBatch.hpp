@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <cstdlib>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace sfext
+{
+	class SpriteBatch final : public sf::Drawable
+	{
+	private:
+		std::vector<sf::Vertex> vertices;
+		const sf::Texture *     texture;
+	public:
+		// Constructors
+		SpriteBatch() : texture(nullptr)
+		{
+		}
+		SpriteBatch(const sf::Texture & tex, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles) : texture(&tex)
+		{
+			build(positions, rectangles);
+		}
+		SpriteBatch(const sf::Texture & tex, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle) : texture(&tex)
+		{
+			build(positions, rectangle);
+		}
+		SpriteBatch(const SpriteBatch & rhs) : vertices(rhs.vertices), texture(rhs.texture)
+		{
+		}
+		// Destructor
+		~SpriteBatch()
+		{
+		}
+		// Accessors
+		const sf::Texture *             getTexture  () const
+		{
+			return texture;
+		}
+		std::size_t                     getQuadCount() const
+		{
+			return vertices.size() / 4;
+		}
+		const std::vector<sf::Vertex> & getVertices () const
+		{
+			return vertices;
+		}
+		sf::Vector2f                    getPosition (std::size_t index) const
+		{
+			assert(("The quad requested does not exist", index < getQuadCount()));
+			return vertices[index * 4].position;
+		}
+		// Mutators
+		void setTexture    (const sf::Texture & tex)
+		{
+			texture = &tex;
+		}
+		void setQuad       (std::size_t index, const sf::Vector2f & position, const sf::IntRect & rectangle)
+		{
+			assert(("The quad requested does not exist", index < getQuadCount()));
+			writeQuad(&vertices[index * 4], position, rectangle);
+		}
+		void setPosition   (std::size_t index, const sf::Vector2f & position)
+		{
+			// Moves a quad without touching its size or texture coordinates
+			assert(("The quad requested does not exist", index < getQuadCount()));
+			sf::Vertex * quad = &vertices[index * 4];
+			sf::Vector2f offset = position - quad[0].position;
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				quad[i].position += offset;
+			}
+		}
+		void setTextureRect(std::size_t index, const sf::IntRect & rectangle)
+		{
+			assert(("The quad requested does not exist", index < getQuadCount()));
+			writeQuad(&vertices[index * 4], vertices[index * 4].position, rectangle);
+		}
+		void setColor      (std::size_t index, const sf::Color & color)
+		{
+			assert(("The quad requested does not exist", index < getQuadCount()));
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				vertices[index * 4 + i].color = color;
+			}
+		}
+		// Utilities
+		void        build (const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles)
+		{
+			// Reuses the existing allocation when the batch is rebuilt with a similar count
+			assert(("Every position needs a rectangle", positions.size() == rectangles.size()));
+			vertices.resize(positions.size() * 4);
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				writeQuad(&vertices[i * 4], positions[i], rectangles[i]);
+			}
+		}
+		void        build (const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle)
+		{
+			vertices.resize(positions.size() * 4);
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				writeQuad(&vertices[i * 4], positions[i], rectangle);
+			}
+		}
+		std::size_t append(const sf::Vector2f & position, const sf::IntRect & rectangle)
+		{
+			// Returns the index of the new quad
+			vertices.resize(vertices.size() + 4);
+			writeQuad(&vertices[vertices.size() - 4], position, rectangle);
+			return getQuadCount() - 1;
+		}
+		void        clear ()
+		{
+			vertices.clear();
+		}
+		void        draw  (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			if (!vertices.empty())
+			{
+				states.texture = texture;
+				target.draw(&vertices[0], vertices.size(), sf::Quads, states);
+			}
+		}
+		// Static Functions
+		static void writeQuad(sf::Vertex * quad, const sf::Vector2f & position, const sf::IntRect & rectangle)
+		{
+			// Writes the four corners of an axis-aligned quad in the order sf::Quads expects
+			// As with sf::Sprite, a negative width or height flips the texture coordinates but not the quad
+			float left = static_cast<float>(rectangle.left);
+			float top = static_cast<float>(rectangle.top);
+			float right = left + static_cast<float>(rectangle.width);
+			float bottom = top + static_cast<float>(rectangle.height);
+			float width = static_cast<float>(std::abs(rectangle.width));
+			float height = static_cast<float>(std::abs(rectangle.height));
+			quad[0].position = position;
+			quad[1].position = sf::Vector2f(position.x + width, position.y);
+			quad[2].position = sf::Vector2f(position.x + width, position.y + height);
+			quad[3].position = sf::Vector2f(position.x, position.y + height);
+			quad[0].texCoords = sf::Vector2f(left, top);
+			quad[1].texCoords = sf::Vector2f(right, top);
+			quad[2].texCoords = sf::Vector2f(right, bottom);
+			quad[3].texCoords = sf::Vector2f(left, bottom);
+		}
+		static void writeQuad(sf::Vertex * quad, const sf::Transform & transform, const sf::IntRect & rectangle)
+		{
+			// Same corners with the quad's local rectangle mapped through 'transform', as sf::Sprite would draw it
+			const float * matrix = transform.getMatrix();
+			float left = static_cast<float>(rectangle.left);
+			float top = static_cast<float>(rectangle.top);
+			float right = left + static_cast<float>(rectangle.width);
+			float bottom = top + static_cast<float>(rectangle.height);
+			float width = static_cast<float>(std::abs(rectangle.width));
+			float height = static_cast<float>(std::abs(rectangle.height));
+			sf::Vector2f origin(matrix[12], matrix[13]);
+			sf::Vector2f across(matrix[0] * width, matrix[1] * width);
+			sf::Vector2f down(matrix[4] * height, matrix[5] * height);
+			quad[0].position = origin;
+			quad[1].position = origin + across;
+			quad[2].position = origin + across + down;
+			quad[3].position = origin + down;
+			quad[0].texCoords = sf::Vector2f(left, top);
+			quad[1].texCoords = sf::Vector2f(right, top);
+			quad[2].texCoords = sf::Vector2f(right, bottom);
+			quad[3].texCoords = sf::Vector2f(left, bottom);
+		}
+		static void drawQuad (sf::RenderTarget & target, const sf::Texture * tex, const sf::IntRect & rectangle, const sf::Color & color, const sf::Transform & transform, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Draws one quad the way sf::Sprite does, from a stack buffer, without constructing a sprite
+			sf::Vertex quad[4];
+			writeQuad(quad, sf::Vector2f(0.f, 0.f), rectangle);
+			quad[0].color = quad[1].color = quad[2].color = quad[3].color = color;
+			states.transform.combine(transform);
+			states.texture = tex;
+			target.draw(quad, 4, sf::Quads, states);
+		}
+		static sf::Transform getTransformAt(const sf::Transformable & transformable, const sf::Vector2f & position)
+		{
+			// The transform 'transformable' would have if it were moved to 'position'
+			sf::Transform transform;
+			transform.translate(position - transformable.getPosition());
+			return transform.combine(transformable.getTransform());
+		}
+	};
+}
\ No newline at end of file
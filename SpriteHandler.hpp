@@ -3,12 +3,19 @@
 #include <cassert>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/String.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/View.hpp>
 
+#include "ThreadPool.hpp"
 #include "TextureHandler.hpp"
+#include "SpriteBatch.hpp"
+#include "StaticSpriteLayer.hpp"
+#include "QuadKernel.hpp"
+#include "Culling.hpp"
 
 namespace sfext
 {
@@ -22,38 +29,110 @@ namespace sfext
 	private:
 		TextureHandler textures;
 		std::map<sf::String, sf::Sprite> sprites;
+		std::vector<sf::Sprite *> spriteSlots; // Indexed by the texture handle of the same alias
+		std::size_t parallelThreshold;
+		void rebindSprite(const sf::String & alias)
+		{
+			ResourceHandle handle = textures.getHandle(alias);
+			if (spriteSlots.size() <= handle.index)
+			{
+				spriteSlots.resize(handle.index + 1, nullptr);
+			}
+			spriteSlots[handle.index] = &sprites.at(alias);
+		}
+		void addSprite(const sf::String & alias)
+		{
+			sprites[alias] = sf::Sprite(textures.getTexture(alias));
+			rebindSprite(alias);
+		}
+		const sf::Texture & useTexture(const ResourceHandle & handle)
+		{
+			// Counts as a use for the texture budget; a texture reloaded after eviction is a new object, so the sprite is pointed at it
+			const sf::Texture & texture = textures.getTexture(handle);
+			sf::Sprite & sprite = *spriteSlots[handle.index];
+			if (sprite.getTexture() != &texture)
+			{
+				sprite.setTexture(texture);
+			}
+			return texture;
+		}
 	public:
 		// Constructors
-		SpriteHandler()
+		SpriteHandler() : parallelThreshold(50000)
 		{
 		}
-		explicit SpriteHandler(const TextureHandler & textureHandler) : textures(textureHandler)
+		explicit SpriteHandler(const TextureHandler & textureHandler) : textures(textureHandler), parallelThreshold(50000)
 		{
 			for (const auto & texture : textures)
 			{
-				sprites[texture.first] = sf::Sprite(texture.second);
+				addSprite(texture.first);
 			}
 		}
-		SpriteHandler         (const SpriteHandler & rhs) : textures(rhs.textures), sprites(rhs.sprites)
+		SpriteHandler         (const SpriteHandler & rhs) : textures(rhs.textures), sprites(rhs.sprites), parallelThreshold(rhs.parallelThreshold)
 		{
+			for (const auto & sprite : sprites)
+			{
+				rebindSprite(sprite.first);
+			}
 		}
 		// Destructor
 		~SpriteHandler()
 		{
 		}
+		// Assignment
+		SpriteHandler & operator =(const SpriteHandler & rhs)
+		{
+			textures = rhs.textures;
+			sprites = rhs.sprites;
+			parallelThreshold = rhs.parallelThreshold;
+			spriteSlots.clear();
+			for (const auto & sprite : sprites)
+			{
+				rebindSprite(sprite.first);
+			}
+			return *this;
+		}
 		// Accessors
 		sf::Vector2f           getPosition      (const sf::String & alias) const
 		{
-			if (hasTexture(alias))
+			ConstSpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.cend())
 			{
-				return sprites.at(alias).getPosition();
+				return sprite->second.getPosition();
 			}
 			return sf::Vector2f();
 		}
+		ResourceHandle         getHandle        (const sf::String & alias) const
+		{
+			// The same handle addresses both the sprite and its texture
+			return textures.getHandle(alias);
+		}
+		sf::Sprite &           getSprite        (const ResourceHandle & handle)
+		{
+			assert(("The sprite requested does not exist", hasTexture(handle)));
+			useTexture(handle);
+			return *spriteSlots[handle.index];
+		}
+		const sf::Sprite &     getSprite        (const ResourceHandle & handle) const
+		{
+			// Does not reload an evicted texture, so only the sprite's transform, colour and rectangle are safe to use with a budget set
+			assert(("The sprite requested does not exist", hasTexture(handle)));
+			return *spriteSlots[handle.index];
+		}
+		const sf::Texture &    getTexture       (const ResourceHandle & handle)
+		{
+			// Same as TextureHandler::getTexture, and also keeps the sprite pointed at a reloaded texture
+			assert(("The texture requested does not exist", hasTexture(handle)));
+			return useTexture(handle);
+		}
 		const TextureHandler & getTextureHandler() const
 		{
 			return textures;
 		}
+		std::size_t            getParallelThreshold() const
+		{
+			return parallelThreshold;
+		}
 		// Mutators
 		void setRepeated   (const sf::String & alias, bool repeated)
 		{
@@ -63,110 +142,156 @@ namespace sfext
 		{
 			textures.setSmooth(alias, smooth);
 		}
+		void setBudget     (std::size_t byteBudget)
+		{
+			textures.setBudget(byteBudget);
+		}
+		void setPinned     (const sf::String & alias, bool pinned)
+		{
+			// Pin textures that SpriteBatch or StaticSpriteLayer objects point to while a budget is set, or they may be evicted under them
+			textures.setPinned(alias, pinned);
+			if (pinned && hasTexture(alias))
+			{
+				useTexture(getHandle(alias));
+			}
+		}
+		void setParallelThreshold(std::size_t instanceCount)
+		{
+			// Batches with at least this many instances build their vertices on the shared thread pool
+			parallelThreshold = instanceCount;
+		}
 		void setPosition   (const sf::String & alias, float x, float y)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setPosition(x, y);
+				sprite->second.setPosition(x, y);
 			}
 		}
 		void setPosition   (const sf::String & alias, const sf::Vector2f & position)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setPosition(position);
+				sprite->second.setPosition(position);
 			}
 		}
 		void move          (const sf::String & alias, float x, float y)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites.at(alias).move(x, y);
+				sprite->second.move(x, y);
 			}
 		}
 		void move          (const sf::String & alias, const sf::Vector2f & offset)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites.at(alias).move(offset);
+				sprite->second.move(offset);
 			}
 		}
 		void setScale      (const sf::String & alias, float x, float y)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setScale(x, y);
+				sprite->second.setScale(x, y);
 			}
 		}
 		void setScale      (const sf::String & alias, const sf::Vector2f & factors)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setScale(factors);
+				sprite->second.setScale(factors);
 			}
 		}
 		void scale         (const sf::String & alias, float x, float y)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].scale(x, y);
+				sprite->second.scale(x, y);
 			}
 		}
 		void scale         (const sf::String & alias, const sf::Vector2f & factors)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].scale(factors);
+				sprite->second.scale(factors);
 			}
 		}
 		void setColor      (const sf::String & alias, const sf::Color & color)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setColor(color);
+				sprite->second.setColor(color);
 			}
 		}
 		void setTextureRect(const sf::String & alias, const sf::IntRect & rectangle)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setTextureRect(rectangle);
+				sprite->second.setTextureRect(rectangle);
 			}
 		}
 		void setRotation   (const sf::String & alias, float angle)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setRotation(angle);
+				sprite->second.setRotation(angle);
 			}
 		}
 		void rotate        (const sf::String & alias, float angle)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].rotate(angle);
+				sprite->second.rotate(angle);
 			}
 		}
 		void setOrigin     (const sf::String & alias, float x, float y)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setOrigin(x, y);
+				sprite->second.setOrigin(x, y);
 			}
 		}
 		void setOrigin     (const sf::String & alias, const sf::Vector2f & origin)
 		{
-			if (hasTexture(alias))
+			SpriteIterator sprite = sprites.find(alias);
+			if (sprite != sprites.end())
 			{
-				sprites[alias].setOrigin(origin);
+				sprite->second.setOrigin(origin);
 			}
 		}
 		// Utilities
+		template <class F>
+		void buildQuads   (std::size_t count, F writeQuads) const
+		{
+			// Calls writeQuads(first, last) over [0, count); large batches are split across the shared pool, each range
+			// writing only its own quads of a buffer the caller sized up front, so no locking is needed
+			if (count >= parallelThreshold && count > 1)
+			{
+				oak::ThreadPool::getShared().parallelFor(count, parallelThreshold / 4 + 1, writeQuads);
+			}
+			else
+			{
+				writeQuads(0, count);
+			}
+		}
 		bool addTexture   (const sf::String & filePath, const sf::String & alias, const sf::IntRect & area = sf::IntRect())
 		{
 			if (textures.addTexture(filePath, alias, area))
 			{
-				sprites[alias] = sf::Sprite(textures.getTexture(alias));
+				addSprite(alias);
 				return true;
 			}
 			return false;
@@ -175,7 +300,7 @@ namespace sfext
 		{
 			if (textures.addTexture(filePath, alias, repeated, smooth, area))
 			{
-				sprites[alias] = sf::Sprite(textures.getTexture(alias));
+				addSprite(alias);
 				return true;
 			}
 			return false;
@@ -184,7 +309,7 @@ namespace sfext
 		{
 			if (textures.addTexture(image, alias, area))
 			{
-				sprites[alias] = sf::Sprite(textures.getTexture(alias));
+				addSprite(alias);
 				return true;
 			}
 			return false;
@@ -193,7 +318,7 @@ namespace sfext
 		{
 			if (textures.addTexture(image, alias, repeated, smooth, area))
 			{
-				sprites[alias] = sf::Sprite(textures.getTexture(alias));
+				addSprite(alias);
 				return true;
 			}
 			return false;
@@ -202,101 +327,377 @@ namespace sfext
 		{
 			return textures.hasTexture(alias);
 		}
+		bool hasTexture   (const ResourceHandle & handle) const
+		{
+			return textures.hasTexture(handle);
+		}
+		void trim         ()
+		{
+			textures.trim();
+		}
 		bool removeTexture(const sf::String & alias)
 		{
+			ResourceHandle handle = textures.getHandle(alias);
 			if (textures.removeTexture(alias))
 			{
+				spriteSlots[handle.index] = nullptr;
 				ConstSpriteIterator sprite = sprites.find(alias);
 				sprites.erase(sprite);
 				return true;
 			}
 			return false;
 		}
-		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::RenderStates states = sf::RenderStates::Default) const
+		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			draw(target, getHandle(alias), states);
+		}
+		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::Vector2f & position, const sf::RenderStates states = sf::RenderStates::Default)
+		{
+			draw(target, getHandle(alias), position, states);
+		}
+		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::IntRect & rectangle, const sf::RenderStates states = sf::RenderStates::Default)
+		{
+			draw(target, getHandle(alias), rectangle, states);
+		}
+		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::Vector2f & position, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			draw(target, getHandle(alias), position, rectangle, states);
+		}
+		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			batch(target, getHandle(alias), positions, states);
+		}
+		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			batch(target, getHandle(alias), positions, rectangles, states);
+		}
+		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			batch(target, getHandle(alias), positions, rectangle, states);
+		}
+		void batch        (sf::RenderTarget & target, const sf::String & alias, const QuadStreams & quads, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			batch(target, getHandle(alias), quads, states);
+		}
+		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Transform> & transforms, const std::vector<sf::Color> & colors, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			batch(target, getHandle(alias), transforms, colors, states);
+		}
+		void draw         (sf::RenderTarget & target, const ResourceHandle & handle, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			if (hasTexture(handle))
 			{
-				target.draw(sprites.at(alias), states);
+				useTexture(handle);
+				target.draw(getSprite(handle), states);
 			}
 		}
-		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::Vector2f & position, const sf::RenderStates states = sf::RenderStates::Default) const
+		void draw         (sf::RenderTarget & target, const ResourceHandle & handle, const sf::Vector2f & position, const sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			if (hasTexture(handle))
 			{
-				sf::Sprite tempSprite(sprites.at(alias));
-				tempSprite.setPosition(position);
-				target.draw(tempSprite, states);
+				useTexture(handle);
+				const sf::Sprite & sprite = getSprite(handle);
+				SpriteBatch::drawQuad(target, sprite.getTexture(), sprite.getTextureRect(), sprite.getColor(), SpriteBatch::getTransformAt(sprite, position), states);
 			}
 		}
-		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::IntRect & rectangle, const sf::RenderStates states = sf::RenderStates::Default) const
+		void draw         (sf::RenderTarget & target, const ResourceHandle & handle, const sf::IntRect & rectangle, const sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			if (hasTexture(handle))
 			{
-				sf::Sprite tempSprite(sprites.at(alias));
-				tempSprite.setTextureRect(rectangle);
-				target.draw(tempSprite, states);
+				useTexture(handle);
+				const sf::Sprite & sprite = getSprite(handle);
+				SpriteBatch::drawQuad(target, sprite.getTexture(), rectangle, sprite.getColor(), sprite.getTransform(), states);
 			}
 		}
-		void draw         (sf::RenderTarget & target, const sf::String & alias, sf::Vector2f & position, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default) const
+		void draw         (sf::RenderTarget & target, const ResourceHandle & handle, const sf::Vector2f & position, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			if (hasTexture(handle))
 			{
-				sf::Sprite tempSprite(sprites.at(alias));
-				tempSprite.setTextureRect(rectangle);
-				tempSprite.setPosition(position);
-				target.draw(tempSprite, states);
+				useTexture(handle);
+				const sf::Sprite & sprite = getSprite(handle);
+				SpriteBatch::drawQuad(target, sprite.getTexture(), rectangle, sprite.getColor(), SpriteBatch::getTransformAt(sprite, position), states);
 			}
 		}
-		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, sf::RenderStates states = sf::RenderStates::Default) const
+		void batch        (sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			if (hasTexture(handle))
 			{
-				sf::VertexArray vertices(sf::Quads);
-				sf::FloatRect globalBounds = sprites.at(alias).getGlobalBounds();
-				sf::IntRect textureBounds = sprites.at(alias).getTextureRect();
-				for (const sf::Vector2f & position : positions)
+				sf::VertexArray vertices(sf::Quads, positions.size() * 4);
+				sf::FloatRect globalBounds = getSprite(handle).getGlobalBounds();
+				sf::IntRect textureBounds = getSprite(handle).getTextureRect();
+				sf::Vector2f textureSize(static_cast<float>(textureBounds.width), static_cast<float>(textureBounds.height));
+				sf::Vertex * quads = positions.empty() ? nullptr : &vertices[0];
+				buildQuads(positions.size(), [&](std::size_t first, std::size_t last)
 				{
-					vertices.append(sf::Vertex(position, sf::Vector2f(0.f, 0.f)));
-					vertices.append(sf::Vertex(position + sf::Vector2f(globalBounds.width, 0.f), sf::Vector2f(static_cast<float>(textureBounds.width), 0.f)));
-					vertices.append(sf::Vertex(position + sf::Vector2f(globalBounds.width, globalBounds.height), sf::Vector2f(static_cast<float>(textureBounds.width), static_cast<float>(textureBounds.height))));
-					vertices.append(sf::Vertex(position + sf::Vector2f(0.f, globalBounds.height), sf::Vector2f(0.f, static_cast<float>(textureBounds.height))));
-				}
-				states.texture = &textures.getTexture(alias);
+					for (std::size_t i = first; i < last; ++i)
+					{
+						sf::Vertex * quad = quads + i * 4;
+						quad[0] = sf::Vertex(positions[i], sf::Vector2f(0.f, 0.f));
+						quad[1] = sf::Vertex(positions[i] + sf::Vector2f(globalBounds.width, 0.f), sf::Vector2f(textureSize.x, 0.f));
+						quad[2] = sf::Vertex(positions[i] + sf::Vector2f(globalBounds.width, globalBounds.height), textureSize);
+						quad[3] = sf::Vertex(positions[i] + sf::Vector2f(0.f, globalBounds.height), sf::Vector2f(0.f, textureSize.y));
+					}
+				});
+				states.texture = &useTexture(handle);
 				target.draw(vertices, states);
 			}
 		}
-		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, sf::RenderStates states = sf::RenderStates::Default) const
+		void batch        (sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias) && positions.size() == rectangles.size())
+			if (hasTexture(handle) && positions.size() == rectangles.size())
 			{
-				sf::VertexArray vertices(sf::Quads);
-				for (unsigned int i = 0; i < positions.size(); ++i)
+				sf::VertexArray vertices(sf::Quads, positions.size() * 4);
+				sf::Vertex * quads = positions.empty() ? nullptr : &vertices[0];
+				buildQuads(positions.size(), [&](std::size_t first, std::size_t last)
 				{
-					vertices.append(sf::Vertex(positions.at(i), sf::Vector2f(static_cast<float>(rectangles.at(i).left), static_cast<float>(rectangles.at(i).top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangles.at(i).width), 0.f), sf::Vector2f(static_cast<float>(rectangles.at(i).left) + static_cast<float>(rectangles.at(i).width), static_cast<float>(rectangles.at(i).top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangles.at(i).width), static_cast<float>(rectangles.at(i).height)), sf::Vector2f(static_cast<float>(rectangles.at(i).left) + static_cast<float>(rectangles.at(i).width), static_cast<float>(rectangles.at(i).top) + static_cast<float>(rectangles.at(i).height))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(0.f, static_cast<float>(rectangles.at(i).height)), sf::Vector2f(static_cast<float>(rectangles.at(i).left), static_cast<float>(rectangles.at(i).top) + static_cast<float>(rectangles.at(i).height))));
-				}
-				states.texture = &textures.getTexture(alias);
+					for (std::size_t i = first; i < last; ++i)
+					{
+						SpriteBatch::writeQuad(quads + i * 4, positions[i], rectangles[i]);
+					}
+				});
+				states.texture = &useTexture(handle);
 				target.draw(vertices, states);
 			}
 		}
-		void batch        (sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default) const
+		void batch        (sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, sf::RenderStates states = sf::RenderStates::Default)
 		{
-			if (hasTexture(alias))
+			if (hasTexture(handle))
 			{
-				sf::VertexArray vertices(sf::Quads);
-				for (unsigned int i = 0; i < positions.size(); ++i)
+				sf::VertexArray vertices(sf::Quads, positions.size() * 4);
+				sf::Vertex * quads = positions.empty() ? nullptr : &vertices[0];
+				buildQuads(positions.size(), [&](std::size_t first, std::size_t last)
 				{
-					vertices.append(sf::Vertex(positions.at(i), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), 0.f), sf::Vector2f(static_cast<float>(rectangle.left) + static_cast<float>(rectangle.width), static_cast<float>(rectangle.top))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left) + static_cast<float>(rectangle.width), static_cast<float>(rectangle.top) + static_cast<float>(rectangle.height))));
-					vertices.append(sf::Vertex(positions.at(i) + sf::Vector2f(0.f, static_cast<float>(rectangle.height)), sf::Vector2f(static_cast<float>(rectangle.left), static_cast<float>(rectangle.top) + static_cast<float>(rectangle.height))));
-				}
-				states.texture = &textures.getTexture(alias);
+					for (std::size_t i = first; i < last; ++i)
+					{
+						SpriteBatch::writeQuad(quads + i * 4, positions[i], rectangle);
+					}
+				});
+				states.texture = &useTexture(handle);
 				target.draw(vertices, states);
 			}
 		}
+		void batch        (sf::RenderTarget & target, const ResourceHandle & handle, const QuadStreams & quads, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Rotated and scaled quads for particle-style workloads; the streams are expanded several instances at a time
+			if (hasTexture(handle) && quads.isValid() && quads.size() != 0)
+			{
+				sf::VertexArray vertices(sf::Quads, quads.size() * 4);
+				sf::Vertex * output = &vertices[0];
+				buildQuads(quads.size(), [&](std::size_t first, std::size_t last)
+				{
+					expandQuads(quads, output, first, last);
+				});
+				states.texture = &useTexture(handle);
+				target.draw(vertices, states);
+			}
+		}
+		void batch        (sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Transform> & transforms, const std::vector<sf::Color> & colors, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// One quad per transform (e.g. sf::Transformable::getTransform()) using the sprite's texture rectangle, all in one draw call;
+			// 'colors' is either empty, tinting every instance with the sprite's colour, or holds one colour per transform
+			if (hasTexture(handle) && (colors.empty() || colors.size() == transforms.size()))
+			{
+				const sf::Sprite & sprite = getSprite(handle);
+				sf::IntRect rectangle = sprite.getTextureRect();
+				sf::Color tint = sprite.getColor();
+				sf::VertexArray vertices(sf::Quads, transforms.size() * 4);
+				sf::Vertex * quads = transforms.empty() ? nullptr : &vertices[0];
+				buildQuads(transforms.size(), [&](std::size_t first, std::size_t last)
+				{
+					for (std::size_t i = first; i < last; ++i)
+					{
+						sf::Vertex * quad = quads + i * 4;
+						SpriteBatch::writeQuad(quad, transforms[i], rectangle);
+						quad[0].color = quad[1].color = quad[2].color = quad[3].color = (colors.empty() ? tint : colors[i]);
+					}
+				});
+				states.texture = &useTexture(handle);
+				target.draw(vertices, states);
+			}
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, area, states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, rectangles, area, states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, rectangle, area, states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, rectangles, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, getHandle(alias), positions, rectangle, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, handle, positions, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, handle, positions, rectangles, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			return batchVisible(target, handle, positions, rectangle, getViewBounds(view), states);
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Same quads as batch(), but only those overlapping 'area' are built and drawn
+			CullingStats stats = { 0, 0 };
+			if (hasTexture(handle))
+			{
+				sf::FloatRect globalBounds = getSprite(handle).getGlobalBounds();
+				sf::IntRect textureBounds = getSprite(handle).getTextureRect();
+				sf::Vector2f textureSize(static_cast<float>(textureBounds.width), static_cast<float>(textureBounds.height));
+				std::vector<std::uint32_t> visible;
+				stats.visible = cullQuads(positions, sf::Vector2f(globalBounds.width, globalBounds.height), area, visible);
+				stats.culled = positions.size() - stats.visible;
+				if (stats.visible != 0)
+				{
+					sf::VertexArray vertices(sf::Quads, stats.visible * 4);
+					sf::Vertex * quads = &vertices[0];
+					buildQuads(stats.visible, [&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; ++i)
+						{
+							const sf::Vector2f & position = positions[visible[i]];
+							sf::Vertex * quad = quads + i * 4;
+							quad[0] = sf::Vertex(position, sf::Vector2f(0.f, 0.f));
+							quad[1] = sf::Vertex(position + sf::Vector2f(globalBounds.width, 0.f), sf::Vector2f(textureSize.x, 0.f));
+							quad[2] = sf::Vertex(position + sf::Vector2f(globalBounds.width, globalBounds.height), textureSize);
+							quad[3] = sf::Vertex(position + sf::Vector2f(0.f, globalBounds.height), sf::Vector2f(0.f, textureSize.y));
+						}
+					});
+					states.texture = &useTexture(handle);
+					target.draw(vertices, states);
+				}
+			}
+			return stats;
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			CullingStats stats = { 0, 0 };
+			if (hasTexture(handle) && positions.size() == rectangles.size())
+			{
+				std::vector<std::uint32_t> visible;
+				stats.visible = cullQuads(positions, rectangles, area, visible);
+				stats.culled = positions.size() - stats.visible;
+				if (stats.visible != 0)
+				{
+					sf::VertexArray vertices(sf::Quads, stats.visible * 4);
+					sf::Vertex * quads = &vertices[0];
+					buildQuads(stats.visible, [&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; ++i)
+						{
+							SpriteBatch::writeQuad(quads + i * 4, positions[visible[i]], rectangles[visible[i]]);
+						}
+					});
+					states.texture = &useTexture(handle);
+					target.draw(vertices, states);
+				}
+			}
+			return stats;
+		}
+		CullingStats batchVisible(sf::RenderTarget & target, const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			CullingStats stats = { 0, 0 };
+			if (hasTexture(handle))
+			{
+				std::vector<std::uint32_t> visible;
+				stats.visible = cullQuads(positions, sf::Vector2f(static_cast<float>(rectangle.width), static_cast<float>(rectangle.height)), area, visible);
+				stats.culled = positions.size() - stats.visible;
+				if (stats.visible != 0)
+				{
+					sf::VertexArray vertices(sf::Quads, stats.visible * 4);
+					sf::Vertex * quads = &vertices[0];
+					buildQuads(stats.visible, [&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; ++i)
+						{
+							SpriteBatch::writeQuad(quads + i * 4, positions[visible[i]], rectangle);
+						}
+					});
+					states.texture = &useTexture(handle);
+					target.draw(vertices, states);
+				}
+			}
+			return stats;
+		}
+		SpriteBatch createBatch(const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles)
+		{
+			return createBatch(getHandle(alias), positions, rectangles);
+		}
+		SpriteBatch createBatch(const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle)
+		{
+			return createBatch(getHandle(alias), positions, rectangle);
+		}
+		SpriteBatch createBatch(const sf::String & alias, const std::vector<sf::Vector2f> & positions)
+		{
+			return createBatch(getHandle(alias), positions);
+		}
+		SpriteBatch createBatch(const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles)
+		{
+			// Build once for static scenery and draw the result every frame; an empty batch is returned for unknown handles
+			if (hasTexture(handle) && positions.size() == rectangles.size())
+			{
+				return SpriteBatch(useTexture(handle), positions, rectangles);
+			}
+			return SpriteBatch();
+		}
+		SpriteBatch createBatch(const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle)
+		{
+			if (hasTexture(handle))
+			{
+				return SpriteBatch(useTexture(handle), positions, rectangle);
+			}
+			return SpriteBatch();
+		}
+		SpriteBatch createBatch(const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions)
+		{
+			// Uses the sprite's current texture rectangle for every quad
+			if (hasTexture(handle))
+			{
+				return SpriteBatch(useTexture(handle), positions, getSprite(handle).getTextureRect());
+			}
+			return SpriteBatch();
+		}
+		StaticSpriteLayer createLayer(const sf::String & alias, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::Vector2f & cellSize = sf::Vector2f(512.f, 512.f))
+		{
+			return createLayer(getHandle(alias), positions, rectangles, cellSize);
+		}
+		StaticSpriteLayer createLayer(const sf::String & alias, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::Vector2f & cellSize = sf::Vector2f(512.f, 512.f))
+		{
+			return createLayer(getHandle(alias), positions, rectangle, cellSize);
+		}
+		StaticSpriteLayer createLayer(const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::Vector2f & cellSize = sf::Vector2f(512.f, 512.f))
+		{
+			// Like createBatch(), but drawing only touches the grid cells in view; an empty layer is returned for unknown handles
+			if (hasTexture(handle) && positions.size() == rectangles.size())
+			{
+				return StaticSpriteLayer(useTexture(handle), positions, rectangles, cellSize);
+			}
+			return StaticSpriteLayer(cellSize);
+		}
+		StaticSpriteLayer createLayer(const ResourceHandle & handle, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::Vector2f & cellSize = sf::Vector2f(512.f, 512.f))
+		{
+			if (hasTexture(handle))
+			{
+				return StaticSpriteLayer(useTexture(handle), positions, rectangle, cellSize);
+			}
+			return StaticSpriteLayer(cellSize);
+		}
 		// Iterators
 		SpriteIterator             begin  ()
 		{
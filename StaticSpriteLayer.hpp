@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "SpriteBatch.hpp"
+#include "Culling.hpp"
+
+namespace sfext
+{
+	// Static quads bucketed into a uniform grid once, so drawing a view only walks the cells it overlaps
+	class StaticSpriteLayer final : public sf::Drawable
+	{
+	private:
+		const sf::Texture *        texture;
+		sf::Vector2f               preferredCellSize;
+		sf::Vector2f               cellSize;    // Preferred size, grown along an axis when a sparse layer would need too many cells
+		sf::Vector2f               origin;      // World position of the top left corner of cell (0, 0)
+		sf::Vector2u               gridSize;    // Cells per row and per column
+		sf::Vector2f               largestQuad; // Quads are bucketed by their top left corner, so queries reach back this far
+		std::vector<sf::Vertex>    vertices;    // Four per quad, ordered by cell so each grid row is one contiguous range
+		std::vector<std::uint32_t> cellStarts;  // First quad of each cell, plus one past the last quad
+		std::vector<std::uint32_t> instances;   // Index into the positions given to build() for each quad
+		template <class F>
+		void bucket(const std::vector<sf::Vector2f> & positions, F rectangleAt)
+		{
+			vertices.clear();
+			cellStarts.clear();
+			instances.clear();
+			gridSize = sf::Vector2u(0, 0);
+			largestQuad = sf::Vector2f(0.f, 0.f);
+			if (positions.empty())
+			{
+				return;
+			}
+			sf::Vector2f minimum = positions[0];
+			sf::Vector2f maximum = positions[0];
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				minimum.x = std::min(minimum.x, positions[i].x);
+				minimum.y = std::min(minimum.y, positions[i].y);
+				maximum.x = std::max(maximum.x, positions[i].x);
+				maximum.y = std::max(maximum.y, positions[i].y);
+				largestQuad.x = std::max(largestQuad.x, static_cast<float>(std::abs(rectangleAt(i).width)));
+				largestQuad.y = std::max(largestQuad.y, static_cast<float>(std::abs(rectangleAt(i).height)));
+			}
+			origin = minimum;
+			// Capped so a few quads spread far apart cannot allocate a huge cellStarts array
+			double maximumCells = static_cast<double>(std::max<std::size_t>(4096, positions.size() * 4));
+			cellSize = preferredCellSize;
+			double columns = std::floor((maximum.x - minimum.x) / cellSize.x) + 1.0;
+			double rows = std::floor((maximum.y - minimum.y) / cellSize.y) + 1.0;
+			while (columns * rows > maximumCells)
+			{
+				if (columns >= rows)
+				{
+					cellSize.x *= 2.f;
+					columns = std::floor((maximum.x - minimum.x) / cellSize.x) + 1.0;
+				}
+				else
+				{
+					cellSize.y *= 2.f;
+					rows = std::floor((maximum.y - minimum.y) / cellSize.y) + 1.0;
+				}
+			}
+			gridSize.x = static_cast<unsigned int>(columns);
+			gridSize.y = static_cast<unsigned int>(rows);
+			// Counting sort of the quads by cell
+			std::vector<std::uint32_t> cells(positions.size());
+			cellStarts.assign(static_cast<std::size_t>(gridSize.x) * gridSize.y + 1, 0);
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				unsigned int x = std::min(gridSize.x - 1, static_cast<unsigned int>((positions[i].x - origin.x) / cellSize.x));
+				unsigned int y = std::min(gridSize.y - 1, static_cast<unsigned int>((positions[i].y - origin.y) / cellSize.y));
+				cells[i] = y * gridSize.x + x;
+				++cellStarts[cells[i] + 1];
+			}
+			for (std::size_t i = 1; i < cellStarts.size(); ++i)
+			{
+				cellStarts[i] += cellStarts[i - 1];
+			}
+			std::vector<std::uint32_t> next(cellStarts.begin(), cellStarts.end() - 1);
+			vertices.resize(positions.size() * 4);
+			instances.resize(positions.size());
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				std::uint32_t slot = next[cells[i]]++;
+				SpriteBatch::writeQuad(&vertices[slot * 4], positions[i], rectangleAt(i));
+				instances[slot] = static_cast<std::uint32_t>(i);
+			}
+		}
+		bool cellRange(const sf::FloatRect & area, sf::Vector2u & first, sf::Vector2u & last) const
+		{
+			// Inclusive range of cells that can hold a quad overlapping 'area'; false when there are none
+			if (instances.empty())
+			{
+				return false;
+			}
+			float left = (area.left - largestQuad.x - origin.x) / cellSize.x;
+			float top = (area.top - largestQuad.y - origin.y) / cellSize.y;
+			float right = (area.left + area.width - origin.x) / cellSize.x;
+			float bottom = (area.top + area.height - origin.y) / cellSize.y;
+			if (right < 0.f || bottom < 0.f || left >= static_cast<float>(gridSize.x) || top >= static_cast<float>(gridSize.y))
+			{
+				return false;
+			}
+			first.x = static_cast<unsigned int>(std::max(0.f, std::floor(left)));
+			first.y = static_cast<unsigned int>(std::max(0.f, std::floor(top)));
+			last.x = std::min(gridSize.x - 1, static_cast<unsigned int>(right));
+			last.y = std::min(gridSize.y - 1, static_cast<unsigned int>(bottom));
+			return true;
+		}
+	public:
+		// Constructors
+		StaticSpriteLayer         () : texture(nullptr), preferredCellSize(512.f, 512.f), cellSize(512.f, 512.f)
+		{
+		}
+		explicit StaticSpriteLayer(const sf::Vector2f & cell) : texture(nullptr), preferredCellSize(cell), cellSize(cell)
+		{
+			assert(("Cells must have a positive size", cell.x > 0.f && cell.y > 0.f));
+		}
+		StaticSpriteLayer         (const sf::Texture & tex, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, const sf::Vector2f & cell = sf::Vector2f(512.f, 512.f)) : texture(&tex), preferredCellSize(cell), cellSize(cell)
+		{
+			assert(("Cells must have a positive size", cell.x > 0.f && cell.y > 0.f));
+			build(positions, rectangles);
+		}
+		StaticSpriteLayer         (const sf::Texture & tex, const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle, const sf::Vector2f & cell = sf::Vector2f(512.f, 512.f)) : texture(&tex), preferredCellSize(cell), cellSize(cell)
+		{
+			assert(("Cells must have a positive size", cell.x > 0.f && cell.y > 0.f));
+			build(positions, rectangle);
+		}
+		StaticSpriteLayer         (const StaticSpriteLayer & rhs) : texture(rhs.texture), preferredCellSize(rhs.preferredCellSize), cellSize(rhs.cellSize), origin(rhs.origin), gridSize(rhs.gridSize), largestQuad(rhs.largestQuad), vertices(rhs.vertices), cellStarts(rhs.cellStarts), instances(rhs.instances)
+		{
+		}
+		// Destructor
+		~StaticSpriteLayer()
+		{
+		}
+		// Accessors
+		const sf::Texture * getTexture  () const
+		{
+			return texture;
+		}
+		sf::Vector2f        getCellSize () const
+		{
+			// The size used by the last build, at least the one given to the constructor
+			return cellSize;
+		}
+		sf::Vector2u        getGridSize () const
+		{
+			return gridSize;
+		}
+		std::size_t         getQuadCount() const
+		{
+			return instances.size();
+		}
+		// Mutators
+		void setTexture(const sf::Texture & tex)
+		{
+			texture = &tex;
+		}
+		// Utilities
+		void        build (const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles)
+		{
+			// Headless; only the texture pointer is kept, nothing is uploaded
+			assert(("Every position needs a rectangle", positions.size() == rectangles.size()));
+			bucket(positions, [&rectangles](std::size_t i) -> const sf::IntRect &
+			{
+				return rectangles[i];
+			});
+		}
+		void        build (const std::vector<sf::Vector2f> & positions, const sf::IntRect & rectangle)
+		{
+			bucket(positions, [&rectangle](std::size_t) -> const sf::IntRect &
+			{
+				return rectangle;
+			});
+		}
+		void        clear ()
+		{
+			vertices.clear();
+			cellStarts.clear();
+			instances.clear();
+			gridSize = sf::Vector2u(0, 0);
+		}
+		std::size_t query (const sf::FloatRect & area, std::vector<std::uint32_t> & found) const
+		{
+			// Appends the build() indices of every quad in the cells 'area' touches (a superset of the overlapping quads) and returns how many were added
+			std::size_t count = found.size();
+			sf::Vector2u first, last;
+			if (cellRange(area, first, last))
+			{
+				for (unsigned int y = first.y; y <= last.y; ++y)
+				{
+					std::uint32_t begin = cellStarts[y * gridSize.x + first.x];
+					std::uint32_t end = cellStarts[y * gridSize.x + last.x + 1];
+					found.insert(found.end(), instances.begin() + begin, instances.begin() + end);
+				}
+			}
+			return found.size() - count;
+		}
+		std::size_t draw  (sf::RenderTarget & target, const sf::FloatRect & area, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			// One draw per grid row crossing 'area', since a row's cells are contiguous; returns the number of quads submitted
+			std::size_t drawn = 0;
+			sf::Vector2u first, last;
+			if (cellRange(area, first, last))
+			{
+				states.texture = texture;
+				for (unsigned int y = first.y; y <= last.y; ++y)
+				{
+					std::uint32_t begin = cellStarts[y * gridSize.x + first.x];
+					std::uint32_t end = cellStarts[y * gridSize.x + last.x + 1];
+					if (end > begin)
+					{
+						target.draw(&vertices[begin * 4], (end - begin) * 4, sf::Quads, states);
+						drawn += end - begin;
+					}
+				}
+			}
+			return drawn;
+		}
+		std::size_t draw  (sf::RenderTarget & target, const sf::View & view, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			return draw(target, getViewBounds(view), states);
+		}
+		void        draw  (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			// Draws what the target's current view shows
+			draw(target, getViewBounds(target.getView()), states);
+		}
+	};
+}
\ No newline at end of file
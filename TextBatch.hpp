@@ -0,0 +1,260 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Glyph.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace sfext
+{
+	// Lays out many strings into one vertex array per font texture; glyph quads are cached per (font, size, string)
+	class TextBatch final : public sf::Drawable
+	{
+	private:
+		struct RunKey
+		{
+			const sf::Font *            font;
+			unsigned int                characterSize;
+			std::basic_string<sf::Uint32> string;
+			bool operator <(const RunKey & rhs) const
+			{
+				if (font != rhs.font)
+				{
+					return font < rhs.font;
+				}
+				if (characterSize != rhs.characterSize)
+				{
+					return characterSize < rhs.characterSize;
+				}
+				return string < rhs.string;
+			}
+		};
+		struct Run
+		{
+			std::vector<sf::Vertex> quads;  // Relative to the string's position, as sf::Text places them
+			sf::FloatRect           bounds; // Same as sf::Text::getLocalBounds()
+		};
+		std::map<RunKey, Run>                                  runs;
+		std::map<const sf::Texture *, std::vector<sf::Vertex>> pages; // What draw() renders, one vertex array per font texture
+		std::size_t                                            cacheCapacity;
+		std::size_t                                            cacheMisses;
+		const Run & findRun(const sf::Font & font, unsigned int characterSize, const sf::String & str)
+		{
+			RunKey key = { &font, characterSize, str.toUtf32() };
+			std::map<RunKey, Run>::const_iterator run = runs.find(key);
+			if (run != runs.cend())
+			{
+				return run->second;
+			}
+			// Strings that change every frame would grow the cache without bound, so it starts over once full
+			if (runs.size() >= cacheCapacity)
+			{
+				runs.clear();
+			}
+			++cacheMisses;
+			Run & added = runs[key];
+			added.bounds = layout(font, characterSize, key.string.cbegin(), key.string.cend(), added.quads, sf::Vector2f(0.f, 0.f), sf::Color::White);
+			return added;
+		}
+	public:
+		// Constructors
+		TextBatch         () : cacheCapacity(4096), cacheMisses(0)
+		{
+		}
+		explicit TextBatch(std::size_t capacity) : cacheCapacity(capacity), cacheMisses(0)
+		{
+		}
+		TextBatch         (const TextBatch & rhs) : runs(rhs.runs), pages(rhs.pages), cacheCapacity(rhs.cacheCapacity), cacheMisses(rhs.cacheMisses)
+		{
+		}
+		// Destructor
+		~TextBatch()
+		{
+		}
+		// Accessors
+		std::size_t getCacheSize    () const
+		{
+			return runs.size();
+		}
+		std::size_t getCacheCapacity() const
+		{
+			return cacheCapacity;
+		}
+		std::size_t getCacheMisses  () const
+		{
+			// Number of strings that had to be laid out since construction
+			return cacheMisses;
+		}
+		std::size_t getPageCount    () const
+		{
+			// Draw calls the next draw() will issue
+			std::size_t count = 0;
+			for (const auto & page : pages)
+			{
+				count += page.second.empty() ? 0 : 1;
+			}
+			return count;
+		}
+		// Mutators
+		void setCacheCapacity(std::size_t capacity)
+		{
+			cacheCapacity = capacity;
+		}
+		// Utilities
+		sf::FloatRect measure          (const sf::Font & font, unsigned int characterSize, const sf::String & str)
+		{
+			// Local bounds, as sf::Text::getLocalBounds() would report them; cached with the glyph quads
+			return findRun(font, characterSize, str).bounds;
+		}
+		sf::FloatRect add              (const sf::Font & font, unsigned int characterSize, const sf::String & str, const sf::Vector2f & position, const sf::Color & color = sf::Color::White)
+		{
+			// Returns the global bounds of the added string
+			const Run & run = findRun(font, characterSize, str);
+			addVertices(font.getTexture(characterSize), run.quads, position, color);
+			return sf::FloatRect(run.bounds.left + position.x, run.bounds.top + position.y, run.bounds.width, run.bounds.height);
+		}
+		sf::FloatRect addRightAligned  (const sf::Font & font, unsigned int characterSize, const sf::String & str, const sf::Vector2f & position, const sf::Color & color = sf::Color::White)
+		{
+			// Same offset as TextHandler::writeRightAligned
+			return add(font, characterSize, str, sf::Vector2f(position.x - measure(font, characterSize, str).width, position.y), color);
+		}
+		sf::FloatRect addCenterAligned (const sf::Font & font, unsigned int characterSize, const sf::String & str, const sf::Vector2f & position, const sf::Color & color = sf::Color::White)
+		{
+			return add(font, characterSize, str, sf::Vector2f(position.x - measure(font, characterSize, str).width * .5f, position.y), color);
+		}
+		sf::FloatRect addCharacters    (const sf::Font & font, unsigned int characterSize, const char * first, const char * last, const sf::Vector2f & position, const sf::Color & color = sf::Color::White, float alignment = 0.f)
+		{
+			// Lays ASCII characters straight into the page, skipping the cache, so formatted numbers that change every frame never allocate once the page has grown
+			// 'alignment' is the fraction of the width left of 'position': 0 left aligns, .5 centers and 1 right aligns
+			std::vector<sf::Vertex> & page = pages[&font.getTexture(characterSize)];
+			std::size_t begin = page.size();
+			sf::FloatRect bounds = layout(font, characterSize, first, last, page, position, color);
+			float offset = bounds.width * alignment;
+			for (std::size_t i = begin; i < page.size(); ++i)
+			{
+				page[i].position.x -= offset;
+			}
+			return sf::FloatRect(bounds.left + position.x - offset, bounds.top + position.y, bounds.width, bounds.height);
+		}
+		void          addVertices      (const sf::Texture & texture, const std::vector<sf::Vertex> & quads, const sf::Vector2f & offset, const sf::Color & color = sf::Color::White)
+		{
+			// Appends quads laid out elsewhere (see layout) to the page of 'texture', moved by 'offset' and recoloured
+			std::vector<sf::Vertex> & page = pages[&texture];
+			std::size_t first = page.size();
+			page.resize(first + quads.size());
+			for (std::size_t i = 0; i < quads.size(); ++i)
+			{
+				page[first + i].position = quads[i].position + offset;
+				page[first + i].texCoords = quads[i].texCoords;
+				page[first + i].color = color;
+			}
+		}
+		void          clear            ()
+		{
+			// Drops the laid out strings but keeps the glyph cache and the page allocations
+			for (auto & page : pages)
+			{
+				page.second.clear();
+			}
+		}
+		void          clearCache       ()
+		{
+			// Needed if a cached font is destroyed or reloaded
+			runs.clear();
+			pages.clear();
+		}
+		void          draw             (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default) const
+		{
+			for (const auto & page : pages)
+			{
+				if (!page.second.empty())
+				{
+					states.texture = page.first;
+					target.draw(&page.second[0], page.second.size(), sf::Quads, states);
+				}
+			}
+		}
+		// Static Functions
+		template <class Iterator>
+		static sf::FloatRect layout(const sf::Font & font, unsigned int characterSize, Iterator first, Iterator last, std::vector<sf::Vertex> & quads, const sf::Vector2f & position, const sf::Color & color)
+		{
+			// Appends the glyph quads of [first, last) placed at 'position' to 'quads' and returns the local bounds; mirrors sf::Text's geometry for the regular style
+			if (first == last)
+			{
+				return sf::FloatRect();
+			}
+			float spaceAdvance = font.getGlyph(L' ', characterSize, false).advance;
+			float lineSpacing = font.getLineSpacing(characterSize);
+			float x = 0.f;
+			float y = static_cast<float>(characterSize);
+			float minX = static_cast<float>(characterSize);
+			float minY = static_cast<float>(characterSize);
+			float maxX = 0.f;
+			float maxY = 0.f;
+			sf::Uint32 previous = 0;
+			for (; first != last; ++first)
+			{
+				sf::Uint32 current = static_cast<sf::Uint32>(*first);
+				x += font.getKerning(previous, current, characterSize);
+				previous = current;
+				if (current == L' ' || current == L'\t' || current == L'\n' || current == L'\r')
+				{
+					minX = std::min(minX, x);
+					minY = std::min(minY, y);
+					switch (current)
+					{
+					case L' ':
+						{
+							x += spaceAdvance;
+							break;
+						}
+					case L'\t':
+						{
+							x += spaceAdvance * 4.f;
+							break;
+						}
+					case L'\n':
+						{
+							y += lineSpacing;
+							x = 0.f;
+							break;
+						}
+					}
+					maxX = std::max(maxX, x);
+					maxY = std::max(maxY, y);
+					continue;
+				}
+				const sf::Glyph & glyph = font.getGlyph(current, characterSize, false);
+				float left = glyph.bounds.left;
+				float top = glyph.bounds.top;
+				float right = glyph.bounds.left + glyph.bounds.width;
+				float bottom = glyph.bounds.top + glyph.bounds.height;
+				float u1 = static_cast<float>(glyph.textureRect.left);
+				float v1 = static_cast<float>(glyph.textureRect.top);
+				float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width);
+				float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height);
+				quads.push_back(sf::Vertex(sf::Vector2f(position.x + x + left, position.y + y + top), color, sf::Vector2f(u1, v1)));
+				quads.push_back(sf::Vertex(sf::Vector2f(position.x + x + right, position.y + y + top), color, sf::Vector2f(u2, v1)));
+				quads.push_back(sf::Vertex(sf::Vector2f(position.x + x + right, position.y + y + bottom), color, sf::Vector2f(u2, v2)));
+				quads.push_back(sf::Vertex(sf::Vector2f(position.x + x + left, position.y + y + bottom), color, sf::Vector2f(u1, v2)));
+				minX = std::min(minX, x + left);
+				maxX = std::max(maxX, x + right);
+				minY = std::min(minY, y + top);
+				maxY = std::max(maxY, y + bottom);
+				x += glyph.advance;
+			}
+			return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+		}
+	};
+}
\ No newline at end of file
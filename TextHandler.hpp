@@ -2,6 +2,10 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
@@ -9,20 +13,129 @@
 #include <SFML/System/String.hpp>
 
 #include "FontHandler.hpp"
+#include "HandleTable.hpp"
+#include "FormattingFunctions.hpp"
+#include "TextBatch.hpp"
 
 namespace sfext
 {
+	enum class TextAlignment
+	{
+		LEFT,   // The label starts at its position
+		CENTER, // The label is centered horizontally on its position
+		RIGHT   // The label ends at its position
+	};
+
 	class TextHandler final
 	{
 	private:
+		struct Label
+		{
+			sf::String              string;
+			const sf::Font *        font;
+			unsigned int            characterSize;
+			TextAlignment           alignment;
+			sf::Vector2f            position;
+			sf::Color               color;
+			std::vector<sf::Vertex> quads;  // Laid out at the origin; rebuilt only when the string, font, size or alignment changes
+			sf::FloatRect           bounds; // Local, with the alignment applied
+			bool                    visible;
+			bool                    dirty;
+		};
 		FontHandler fonts;
 		sf::Text text;
+		TextBatch batch; // Filled by the queue functions, drawn and emptied by flush()
+		unsigned int precision; // Decimals of the floating point values given to the queue functions
+		HandleTable<Label> labels;
+		TextBatch labelBatch; // Every visible label, rebuilt by drawLabels only after a label changed
+		bool labelsChanged;
+		std::size_t relayouts; // Since the last drawLabels
+		std::size_t lastRelayouts;
+		void relayout(Label & label)
+		{
+			label.quads.clear();
+			label.bounds = label.font ? TextBatch::layout(*label.font, label.characterSize, label.string.begin(), label.string.end(), label.quads, sf::Vector2f(0.f, 0.f), sf::Color::White) : sf::FloatRect();
+			float offset = label.alignment == TextAlignment::RIGHT ? label.bounds.width : label.alignment == TextAlignment::CENTER ? label.bounds.width * .5f : 0.f;
+			for (sf::Vertex & vertex : label.quads)
+			{
+				vertex.position.x -= offset;
+			}
+			label.bounds.left -= offset;
+			label.dirty = false;
+			++relayouts;
+		}
+		void replaceLabelFont(const sf::Font * replaced, const sf::Font * replacement)
+		{
+			// Labels never keep a pointer to a font their handler no longer owns; without a replacement they stop being drawn
+			for (std::uint32_t i = 0; i < labels.capacity(); ++i)
+			{
+				Label * label = labels.getAt(i);
+				if (replaced && label && label->font == replaced)
+				{
+					label->font = replacement;
+					label->dirty = true;
+					labelsChanged = true;
+				}
+			}
+		}
+		Label * findLabel(const ResourceHandle & handle)
+		{
+			Label * label = labels.get(handle);
+			assert(("The label requested does not exist", label != nullptr));
+			return label;
+		}
+		template <class T>
+		std::size_t   format     (char * buffer, T val) const
+		{
+			return std::is_floating_point<T>::value ? ash::formatDecimal(buffer, static_cast<double>(val), precision) : ash::formatInteger(buffer, static_cast<long long>(val));
+		}
+		std::size_t   format     (char * buffer, const sf::Time & val) const
+		{
+			return format(buffer, val.asSeconds());
+		}
+		template <class T>
+		std::size_t   format     (char * buffer, const sf::Vector2<T> & vec) const
+		{
+			// Same layout as write: "(x, y)"
+			std::size_t length = 0;
+			buffer[length++] = '(';
+			length += format(buffer + length, vec.x);
+			buffer[length++] = ',';
+			buffer[length++] = ' ';
+			length += format(buffer + length, vec.y);
+			buffer[length++] = ')';
+			return length;
+		}
+		template <class T>
+		std::size_t   format     (char * buffer, const sf::Vector3<T> & vec) const
+		{
+			std::size_t length = 0;
+			buffer[length++] = '(';
+			length += format(buffer + length, vec.x);
+			buffer[length++] = ',';
+			buffer[length++] = ' ';
+			length += format(buffer + length, vec.y);
+			buffer[length++] = ',';
+			buffer[length++] = ' ';
+			length += format(buffer + length, vec.z);
+			buffer[length++] = ')';
+			return length;
+		}
+		template <class T>
+		sf::FloatRect queueValue (const T & val, const sf::Vector2f & pos, float alignment)
+		{
+			// Formats into a stack buffer and lays the characters out directly, so no string is ever built
+			assert(("No font has been set", text.getFont() != nullptr));
+			char buffer[ash::NUMBER_BUFFER_SIZE * 3 + 8];
+			std::size_t length = format(buffer, val);
+			return batch.addCharacters(*text.getFont(), text.getCharacterSize(), buffer, buffer + length, pos, text.getColor(), alignment);
+		}
 	public:
 		// Constructors
-		TextHandler()
+		TextHandler() : precision(6), labelsChanged(false), relayouts(0), lastRelayouts(0)
 		{
 		}
-		TextHandler(const TextHandler & rhs) : fonts(rhs.fonts), text(rhs.text)
+		TextHandler(const TextHandler & rhs) : fonts(rhs.fonts), text(rhs.text), batch(rhs.batch), precision(rhs.precision), labels(rhs.labels), labelBatch(rhs.labelBatch), labelsChanged(rhs.labelsChanged), relayouts(rhs.relayouts), lastRelayouts(rhs.lastRelayouts)
 		{
 		}
 		// Destructor
@@ -50,27 +163,134 @@ namespace sfext
 		{
 			return text.getPosition();
 		}
+		unsigned int             getPrecision    () const
+		{
+			return precision;
+		}
+		const TextBatch &        getTextBatch    () const
+		{
+			return batch;
+		}
+		TextBatch &              getTextBatch    ()
+		{
+			return batch;
+		}
+		std::size_t              getLabelCount   () const
+		{
+			return labels.size();
+		}
+		std::size_t              getRelayoutCount() const
+		{
+			// Labels laid out again between the two last calls to drawLabels, for profiling
+			return lastRelayouts;
+		}
+		bool                     hasLabel        (const ResourceHandle & label) const
+		{
+			return labels.contains(label);
+		}
+		const sf::String &       getLabelString  (const ResourceHandle & label) const
+		{
+			assert(("The label requested does not exist", hasLabel(label)));
+			return labels.get(label)->string;
+		}
+		sf::FloatRect            getLabelBounds  (const ResourceHandle & label)
+		{
+			// Global bounds; lays the label out now if it changed since it was last drawn
+			Label * found = findLabel(label);
+			if (found->dirty)
+			{
+				relayout(*found);
+			}
+			return sf::FloatRect(found->bounds.left + found->position.x, found->bounds.top + found->position.y, found->bounds.width, found->bounds.height);
+		}
 		// Mutators
-		void setColor        (const sf::Color & color)
+		void setColor             (const sf::Color & color)
 		{
 			text.setColor(color);
 		}
-		void setCharacterSize(unsigned int characterSize)
+		void setCharacterSize     (unsigned int characterSize)
 		{
 			text.setCharacterSize(characterSize);
 		}
-		void setFont         (const sf::String & fontAlias)
+		void setFont              (const sf::String & fontAlias)
+		{
+			setFont(fonts.getHandle(fontAlias));
+		}
+		void setFont              (const ResourceHandle & fontHandle)
+		{
+			if (fonts.hasFont(fontHandle))
+			{
+				text.setFont(*(fonts.getFont(fontHandle)));
+			}
+		}
+		void setPrecision         (unsigned int decimals)
+		{
+			// Capped at 9 by ash::formatDecimal; write is unaffected and keeps std::to_string's 6
+			precision = decimals;
+		}
+		void setLabelString       (const ResourceHandle & label, const sf::String & str)
+		{
+			// Setting the string a label already shows costs a comparison, not a relayout
+			Label * found = findLabel(label);
+			if (found->string != str)
+			{
+				found->string = str;
+				found->dirty = true;
+				labelsChanged = true;
+			}
+		}
+		void setLabelFont         (const ResourceHandle & label, const sf::String & fontAlias)
+		{
+			Label * found = findLabel(label);
+			const sf::Font * font = fonts.getFont(fontAlias);
+			if (font && found->font != font)
+			{
+				found->font = font;
+				found->dirty = true;
+				labelsChanged = true;
+			}
+		}
+		void setLabelCharacterSize(const ResourceHandle & label, unsigned int characterSize)
+		{
+			Label * found = findLabel(label);
+			if (found->characterSize != characterSize)
+			{
+				found->characterSize = characterSize;
+				found->dirty = true;
+				labelsChanged = true;
+			}
+		}
+		void setLabelAlignment    (const ResourceHandle & label, TextAlignment alignment)
 		{
-			if (fonts.hasFont(fontAlias))
+			Label * found = findLabel(label);
+			if (found->alignment != alignment)
 			{
-				text.setFont(*(fonts.getFont(fontAlias)));
+				found->alignment = alignment;
+				found->dirty = true;
+				labelsChanged = true;
 			}
 		}
-		void setPosition     (const sf::Vector2f & position)
+		void setLabelPosition     (const ResourceHandle & label, const sf::Vector2f & position)
+		{
+			// Moving, recolouring or hiding a label keeps its layout
+			findLabel(label)->position = position;
+			labelsChanged = true;
+		}
+		void setLabelColor        (const ResourceHandle & label, const sf::Color & color)
+		{
+			findLabel(label)->color = color;
+			labelsChanged = true;
+		}
+		void setLabelVisible      (const ResourceHandle & label, bool visible)
+		{
+			findLabel(label)->visible = visible;
+			labelsChanged = true;
+		}
+		void setPosition          (const sf::Vector2f & position)
 		{
 			text.setPosition(position);
 		}
-		void setPosition     (float x, float y)
+		void setPosition          (float x, float y)
 		{
 			text.setPosition(x, y);
 		}
@@ -295,17 +515,177 @@ namespace sfext
 			target.draw(text);
 			setPosition(tempPos);
 		}
+		sf::FloatRect measure           (const sf::String & str)
+		{
+			// Same as the local bounds of the text, without rebuilding its geometry once the string is cached
+			assert(("No font has been set", text.getFont() != nullptr));
+			return batch.measure(*text.getFont(), text.getCharacterSize(), str);
+		}
+		sf::FloatRect queue             (const sf::String & str)
+		{
+			return queue(str, getPosition());
+		}
+		sf::FloatRect queue             (const sf::String & str, const sf::Vector2f & pos)
+		{
+			// Like write, but the string is only laid out and drawn with every other queued string on the next flush; returns its bounds
+			assert(("No font has been set", text.getFont() != nullptr));
+			return batch.add(*text.getFont(), text.getCharacterSize(), str, pos, text.getColor());
+		}
+		sf::FloatRect queueRightAligned (const sf::String & str)
+		{
+			return queueRightAligned(str, getPosition());
+		}
+		sf::FloatRect queueRightAligned (const sf::String & str, const sf::Vector2f & pos)
+		{
+			assert(("No font has been set", text.getFont() != nullptr));
+			return batch.addRightAligned(*text.getFont(), text.getCharacterSize(), str, pos, text.getColor());
+		}
+		sf::FloatRect queueCenterAligned(const sf::String & str)
+		{
+			return queueCenterAligned(str, getPosition());
+		}
+		sf::FloatRect queueCenterAligned(const sf::String & str, const sf::Vector2f & pos)
+		{
+			assert(("No font has been set", text.getFont() != nullptr));
+			return batch.addCenterAligned(*text.getFont(), text.getCharacterSize(), str, pos, text.getColor());
+		}
+		sf::FloatRect queue             (int val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 0.f);
+		}
+		sf::FloatRect queue             (float val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 0.f);
+		}
+		sf::FloatRect queue             (double val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 0.f);
+		}
+		sf::FloatRect queue             (const sf::Time & val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 0.f);
+		}
+		template <class T>
+		sf::FloatRect queue             (const sf::Vector2<T> & vec, const sf::Vector2f & pos)
+		{
+			return queueValue(vec, pos, 0.f);
+		}
+		template <class T>
+		sf::FloatRect queue             (const sf::Vector3<T> & vec, const sf::Vector2f & pos)
+		{
+			return queueValue(vec, pos, 0.f);
+		}
+		sf::FloatRect queueRightAligned (int val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 1.f);
+		}
+		sf::FloatRect queueRightAligned (float val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 1.f);
+		}
+		sf::FloatRect queueRightAligned (double val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 1.f);
+		}
+		sf::FloatRect queueRightAligned (const sf::Time & val, const sf::Vector2f & pos)
+		{
+			return queueValue(val, pos, 1.f);
+		}
+		template <class T>
+		sf::FloatRect queueRightAligned (const sf::Vector2<T> & vec, const sf::Vector2f & pos)
+		{
+			return queueValue(vec, pos, 1.f);
+		}
+		template <class T>
+		sf::FloatRect queueRightAligned (const sf::Vector3<T> & vec, const sf::Vector2f & pos)
+		{
+			return queueValue(vec, pos, 1.f);
+		}
+		void          flush             (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// One draw call per font texture for everything queued since the last flush
+			target.draw(batch, states);
+			batch.clear();
+		}
+		ResourceHandle addLabel   (const sf::String & str, const sf::Vector2f & pos, TextAlignment alignment = TextAlignment::LEFT)
+		{
+			// A retained string with the current font, size and colour; it is laid out once and drawn by drawLabels until removed
+			assert(("No font has been set", text.getFont() != nullptr));
+			Label label = { str, text.getFont(), text.getCharacterSize(), alignment, pos, text.getColor(), std::vector<sf::Vertex>(), sf::FloatRect(), true, true };
+			labelsChanged = true;
+			return labels.insert(label);
+		}
+		bool           removeLabel(const ResourceHandle & label)
+		{
+			if (labels.erase(label))
+			{
+				labelsChanged = true;
+				return true;
+			}
+			return false;
+		}
+		void           clearLabels()
+		{
+			labels.clear();
+			labelsChanged = true;
+		}
+		void           drawLabels (sf::RenderTarget & target, sf::RenderStates states = sf::RenderStates::Default)
+		{
+			// Every visible label in one draw call per font texture; the vertices are only rebuilt after a label changed
+			if (labelsChanged)
+			{
+				labelBatch.clear();
+				for (std::uint32_t i = 0; i < labels.capacity(); ++i)
+				{
+					Label * label = labels.getAt(i);
+					if (label && label->visible && label->font)
+					{
+						if (label->dirty)
+						{
+							relayout(*label);
+						}
+						labelBatch.addVertices(label->font->getTexture(label->characterSize), label->quads, label->position, label->color);
+					}
+				}
+				labelsChanged = false;
+			}
+			target.draw(labelBatch, states);
+			lastRelayouts = relayouts;
+			relayouts = 0;
+		}
 		bool addFont           (const sf::String & filePath, const sf::String & fontAlias)
 		{
-			return fonts.addFont(filePath, fontAlias);
+			// Replacing the font in use hands the text the new font before the old one can be released
+			const sf::Font * replaced = fonts.getFont(fontAlias);
+			if (!fonts.addFont(filePath, fontAlias))
+			{
+				return false;
+			}
+			if (replaced)
+			{
+				if (text.getFont() == replaced)
+				{
+					text.setFont(*fonts.getFont(fontAlias));
+				}
+				replaceLabelFont(replaced, fonts.getFont(fontAlias));
+				batch.clearCache();
+			}
+			return true;
 		}
 		bool removeFont        (const sf::String & fontAlias)
 		{
+			// The cached glyph quads and the labels may point to the removed font
+			batch.clearCache();
+			replaceLabelFont(fonts.getFont(fontAlias), nullptr);
 			return fonts.removeFont(fontAlias);
 		}
 		bool hasFont           (const sf::String & fontAlias)
 		{
 			return fonts.hasFont(fontAlias);
 		}
+		std::size_t prewarm    (const sf::String & fontAlias, const std::vector<unsigned int> & sizes, const sf::String & charset)
+		{
+			return fonts.prewarm(fontAlias, sizes, charset);
+		}
 	};
 }
\ No newline at end of file
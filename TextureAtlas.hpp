@@ -0,0 +1,354 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "TextureHandler.hpp"
+
+namespace sfext
+{
+	class SkylinePacker final
+	{
+	private:
+		struct Node
+		{
+			unsigned int x;
+			unsigned int y;
+			unsigned int width;
+		};
+		sf::Vector2u      size;
+		unsigned int      padding;
+		std::vector<Node> skyline;
+		unsigned long     usedArea;
+		// Returns the lowest y at which a rectangle of 'width' can rest when its left edge is at skyline[index].x
+		bool fits(std::size_t index, unsigned int width, unsigned int height, unsigned int & y) const
+		{
+			unsigned int x = skyline[index].x;
+			if (x + width > size.x)
+			{
+				return false;
+			}
+			y = skyline[index].y;
+			unsigned int remaining = width;
+			while (remaining > 0)
+			{
+				if (index >= skyline.size())
+				{
+					return false;
+				}
+				y = std::max(y, skyline[index].y);
+				if (y + height > size.y)
+				{
+					return false;
+				}
+				remaining -= std::min(remaining, skyline[index].width);
+				++index;
+			}
+			return true;
+		}
+		void addNode(std::size_t index, unsigned int x, unsigned int y, unsigned int width)
+		{
+			Node node = { x, y, width };
+			skyline.insert(skyline.begin() + index, node);
+			// Shrink or remove the nodes now covered by the new one
+			for (std::size_t i = index + 1; i < skyline.size(); ++i)
+			{
+				unsigned int previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+				if (skyline[i].x >= previousEnd)
+				{
+					break;
+				}
+				unsigned int shrink = previousEnd - skyline[i].x;
+				if (skyline[i].width > shrink)
+				{
+					skyline[i].x += shrink;
+					skyline[i].width -= shrink;
+					break;
+				}
+				skyline.erase(skyline.begin() + i);
+				--i;
+			}
+			// Merge neighbours of equal height
+			for (std::size_t i = 0; i + 1 < skyline.size(); ++i)
+			{
+				if (skyline[i].y == skyline[i + 1].y)
+				{
+					skyline[i].width += skyline[i + 1].width;
+					skyline.erase(skyline.begin() + i + 1);
+					--i;
+				}
+			}
+		}
+	public:
+		// Constructors
+		SkylinePacker() : padding(0), usedArea(0)
+		{
+			reset(sf::Vector2u(0, 0));
+		}
+		SkylinePacker(const sf::Vector2u & pageSize, unsigned int pad = 0) : padding(pad), usedArea(0)
+		{
+			reset(pageSize);
+		}
+		SkylinePacker(const SkylinePacker & rhs) : size(rhs.size), padding(rhs.padding), skyline(rhs.skyline), usedArea(rhs.usedArea)
+		{
+		}
+		// Destructor
+		~SkylinePacker()
+		{
+		}
+		// Accessors
+		sf::Vector2u  getSize     () const
+		{
+			return size;
+		}
+		unsigned int  getPadding  () const
+		{
+			return padding;
+		}
+		unsigned long getUsedArea () const
+		{
+			return usedArea;
+		}
+		float         getOccupancy() const
+		{
+			// Fraction of the page covered by inserted rectangles (padding excluded)
+			unsigned long area = static_cast<unsigned long>(size.x) * size.y;
+			return area ? static_cast<float>(usedArea) / static_cast<float>(area) : 0.f;
+		}
+		// Utilities
+		void reset (const sf::Vector2u & pageSize)
+		{
+			size = pageSize;
+			usedArea = 0;
+			skyline.clear();
+			Node node = { 0, 0, pageSize.x };
+			skyline.push_back(node);
+		}
+		bool insert(const sf::Vector2u & rectangleSize, sf::IntRect & result)
+		{
+			// Bottom-left skyline heuristic: lowest resting position first, then the tightest fit
+			unsigned int width = rectangleSize.x + padding;
+			unsigned int height = rectangleSize.y + padding;
+			std::size_t bestIndex = skyline.size();
+			unsigned int bestTop = std::numeric_limits<unsigned int>::max();
+			unsigned int bestWidth = std::numeric_limits<unsigned int>::max();
+			unsigned int bestY = 0;
+			for (std::size_t i = 0; i < skyline.size(); ++i)
+			{
+				unsigned int y = 0;
+				if (fits(i, width, height, y) && (y + height < bestTop || (y + height == bestTop && skyline[i].width < bestWidth)))
+				{
+					bestIndex = i;
+					bestTop = y + height;
+					bestWidth = skyline[i].width;
+					bestY = y;
+				}
+			}
+			if (bestIndex == skyline.size())
+			{
+				return false;
+			}
+			result = sf::IntRect(static_cast<int>(skyline[bestIndex].x), static_cast<int>(bestY), static_cast<int>(rectangleSize.x), static_cast<int>(rectangleSize.y));
+			addNode(bestIndex, skyline[bestIndex].x, bestY + height, width);
+			usedArea += static_cast<unsigned long>(rectangleSize.x) * rectangleSize.y;
+			return true;
+		}
+	};
+
+	struct AtlasRegion
+	{
+		std::size_t page;
+		sf::IntRect rectangle;
+	};
+
+	class TextureAtlas final
+	{
+	private:
+		std::map<sf::String, sf::Image>   images;
+		std::map<sf::String, AtlasRegion> regions;
+		std::vector<SkylinePacker>        packers;
+		std::vector<sf::Texture>          pages;
+		sf::Vector2u                      pageSize;
+		unsigned int                      padding;
+		sf::Time                          packTime;
+		sf::Time                          buildTime;
+	public:
+		// Constructors
+		TextureAtlas         () : pageSize(2048, 2048), padding(1)
+		{
+		}
+		explicit TextureAtlas(const sf::Vector2u & size, unsigned int pad = 1) : pageSize(size), padding(pad)
+		{
+		}
+		TextureAtlas         (const TextureAtlas & rhs) : images(rhs.images), regions(rhs.regions), packers(rhs.packers), pages(rhs.pages), pageSize(rhs.pageSize), padding(rhs.padding), packTime(rhs.packTime), buildTime(rhs.buildTime)
+		{
+		}
+		// Destructor
+		~TextureAtlas()
+		{
+		}
+		// Accessors
+		const AtlasRegion & getRegion    (const sf::String & alias) const
+		{
+			assert(("The region requested does not exist", hasRegion(alias)));
+			return regions.at(alias);
+		}
+		const sf::Texture & getTexture   (std::size_t page) const
+		{
+			assert(("The atlas page requested does not exist", page < pages.size()));
+			return pages.at(page);
+		}
+		const sf::Texture & getTexture   (const sf::String & alias) const
+		{
+			return getTexture(getRegion(alias).page);
+		}
+		std::size_t         getPageCount () const
+		{
+			return packers.size();
+		}
+		sf::Vector2u        getPageSize  () const
+		{
+			return pageSize;
+		}
+		float               getEfficiency() const
+		{
+			// Fraction of all allocated page area covered by packed images
+			unsigned long used = 0;
+			for (const SkylinePacker & packer : packers)
+			{
+				used += packer.getUsedArea();
+			}
+			unsigned long total = static_cast<unsigned long>(pageSize.x) * pageSize.y * packers.size();
+			return total ? static_cast<float>(used) / static_cast<float>(total) : 0.f;
+		}
+		sf::Time            getPackTime  () const
+		{
+			// Time spent placing rectangles on the CPU during the last pack()
+			return packTime;
+		}
+		sf::Time            getBuildTime () const
+		{
+			// Time spent in the last build(), packing and texture upload included
+			return buildTime;
+		}
+		// Mutators
+		void setPageSize(const sf::Vector2u & size)
+		{
+			pageSize = size;
+		}
+		void setPadding (unsigned int pad)
+		{
+			padding = pad;
+		}
+		// Utilities
+		bool addImage   (const sf::Image & image, const sf::String & alias)
+		{
+			if (image.getSize().x + padding > pageSize.x || image.getSize().y + padding > pageSize.y)
+			{
+				return false;
+			}
+			images[alias] = image;
+			return true;
+		}
+		bool addTexture (TextureHandler & textureHandler, const sf::String & alias)
+		{
+			// Reads the texture back from the GPU, reloading it first if it was evicted; prefer addImage when the source image is still at hand
+			return textureHandler.hasTexture(alias) && addImage(textureHandler.copyToImage(alias), alias);
+		}
+		void addTextures(TextureHandler & textureHandler)
+		{
+			for (ConstTextureIterator texture = textureHandler.cbegin(); texture != textureHandler.cend(); ++texture)
+			{
+				addTexture(textureHandler, texture->first);
+			}
+		}
+		bool hasRegion  (const sf::String & alias) const
+		{
+			return regions.find(alias) != regions.cend();
+		}
+		bool removeImage(const sf::String & alias)
+		{
+			// Takes effect on the next pack() or build()
+			return images.erase(alias) != 0;
+		}
+		bool pack       ()
+		{
+			// Places every image without touching the GPU; usable headless
+			sf::Clock clock;
+			regions.clear();
+			packers.clear();
+			std::vector<std::map<sf::String, sf::Image>::const_iterator> order;
+			for (auto image = images.cbegin(); image != images.cend(); ++image)
+			{
+				order.push_back(image);
+			}
+			std::sort(order.begin(), order.end(), [](std::map<sf::String, sf::Image>::const_iterator lhs, std::map<sf::String, sf::Image>::const_iterator rhs)
+			{
+				// Tallest first keeps the skyline flat
+				return lhs->second.getSize().y != rhs->second.getSize().y ? lhs->second.getSize().y > rhs->second.getSize().y : lhs->second.getSize().x > rhs->second.getSize().x;
+			});
+			bool packedAll = true;
+			for (const auto & image : order)
+			{
+				AtlasRegion region = { 0, sf::IntRect() };
+				while (region.page < packers.size() && !packers[region.page].insert(image->second.getSize(), region.rectangle))
+				{
+					++region.page;
+				}
+				if (region.page == packers.size())
+				{
+					packers.push_back(SkylinePacker(pageSize, padding));
+					if (!packers.back().insert(image->second.getSize(), region.rectangle))
+					{
+						packers.pop_back();
+						packedAll = false;
+						continue;
+					}
+				}
+				regions[image->first] = region;
+			}
+			packTime = clock.getElapsedTime();
+			return packedAll;
+		}
+		bool build      ()
+		{
+			// Packs, composes each page on the CPU, then uploads one texture per page
+			sf::Clock clock;
+			bool packedAll = pack();
+			std::vector<sf::Image> composed(packers.size());
+			for (sf::Image & page : composed)
+			{
+				page.create(pageSize.x, pageSize.y, sf::Color::Transparent);
+			}
+			for (const auto & region : regions)
+			{
+				composed[region.second.page].copy(images.at(region.first), region.second.rectangle.left, region.second.rectangle.top);
+			}
+			pages.assign(composed.size(), sf::Texture());
+			for (std::size_t i = 0; i < composed.size(); ++i)
+			{
+				packedAll = pages[i].loadFromImage(composed[i]) && packedAll;
+			}
+			buildTime = clock.getElapsedTime();
+			return packedAll;
+		}
+		void clear      ()
+		{
+			images.clear();
+			regions.clear();
+			packers.clear();
+			pages.clear();
+		}
+	};
+}
\ No newline at end of file
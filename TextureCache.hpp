@@ -0,0 +1,141 @@
+#pragma once
+
+#include <map>
+#include <list>
+#include <memory>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/String.hpp>
+
+namespace sfext
+{
+	class TextureCache final
+	{
+	private:
+		struct Key
+		{
+			sf::String  filePath;
+			sf::IntRect area;
+			bool operator <(const Key & rhs) const
+			{
+				if (filePath != rhs.filePath)
+				{
+					return filePath < rhs.filePath;
+				}
+				if (area.left != rhs.area.left)
+				{
+					return area.left < rhs.area.left;
+				}
+				if (area.top != rhs.area.top)
+				{
+					return area.top < rhs.area.top;
+				}
+				if (area.width != rhs.area.width)
+				{
+					return area.width < rhs.area.width;
+				}
+				return area.height < rhs.area.height;
+			}
+		};
+		struct Entry
+		{
+			std::shared_ptr<sf::Texture> texture;
+			std::size_t                  bytes;
+			std::list<Key>::iterator     recency;
+		};
+		std::map<Key, Entry> entries;
+		std::list<Key>       recency; // Most recently acquired first
+		std::size_t          budget;
+		std::size_t          residentBytes;
+		std::size_t          evictions;
+	public:
+		// Constructors
+		TextureCache         () : budget(static_cast<std::size_t>(-1)), residentBytes(0), evictions(0)
+		{
+		}
+		explicit TextureCache(std::size_t byteBudget) : budget(byteBudget), residentBytes(0), evictions(0)
+		{
+		}
+		TextureCache         (const TextureCache & rhs) = delete;
+		// Destructor
+		~TextureCache()
+		{
+		}
+		// Accessors
+		std::size_t getBudget       () const
+		{
+			return budget;
+		}
+		std::size_t getResidentBytes() const
+		{
+			return residentBytes;
+		}
+		std::size_t getEvictionCount() const
+		{
+			return evictions;
+		}
+		std::size_t getSize         () const
+		{
+			return entries.size();
+		}
+		// Mutators
+		void setBudget(std::size_t byteBudget)
+		{
+			budget = byteBudget;
+			trim();
+		}
+		// Utilities
+		std::shared_ptr<sf::Texture> acquire (const sf::String & filePath, const sf::IntRect & area = sf::IntRect())
+		{
+			// Every caller asking for the same file and area shares one texture; returns nullptr if loading fails
+			Key key = { filePath, area };
+			std::map<Key, Entry>::iterator entry = entries.find(key);
+			if (entry != entries.end())
+			{
+				recency.splice(recency.begin(), recency, entry->second.recency);
+				return entry->second.texture;
+			}
+			std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>();
+			if (!texture->loadFromFile(filePath, area))
+			{
+				return nullptr;
+			}
+			recency.push_front(key);
+			Entry added = { texture, static_cast<std::size_t>(texture->getSize().x) * texture->getSize().y * 4, recency.begin() };
+			entries[key] = added;
+			residentBytes += added.bytes;
+			trim();
+			return texture;
+		}
+		bool                         contains(const sf::String & filePath, const sf::IntRect & area = sf::IntRect()) const
+		{
+			Key key = { filePath, area };
+			return entries.find(key) != entries.cend();
+		}
+		void                         trim    ()
+		{
+			// Drops least recently acquired textures that nobody outside the cache references until the budget is met
+			std::list<Key>::iterator candidate = recency.end();
+			while (residentBytes > budget && candidate != recency.begin())
+			{
+				--candidate;
+				std::map<Key, Entry>::iterator entry = entries.find(*candidate);
+				if (entry->second.texture.use_count() == 1)
+				{
+					residentBytes -= entry->second.bytes;
+					++evictions;
+					entries.erase(entry);
+					candidate = recency.erase(candidate);
+				}
+			}
+		}
+		void                         clear   ()
+		{
+			// Handlers keep the textures they already hold
+			entries.clear();
+			recency.clear();
+			residentBytes = 0;
+		}
+	};
+}
\ No newline at end of file
@@ -1,97 +1,455 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include <cassert>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
 
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/String.hpp>
 
+#include "HandleTable.hpp"
+#include "TextureCache.hpp"
+
 namespace sfext
 {
-	typedef std::map<sf::String, sf::Texture>::iterator               TextureIterator;
-	typedef std::map<sf::String, sf::Texture>::const_iterator         ConstTextureIterator;
-	typedef std::map<sf::String, sf::Texture>::reverse_iterator       ReverseTextureIterator;
-	typedef std::map<sf::String, sf::Texture>::const_reverse_iterator ConstReverseTextureIterator;
+	typedef std::map<sf::String, std::shared_ptr<sf::Texture>>::iterator               TextureIterator;
+	typedef std::map<sf::String, std::shared_ptr<sf::Texture>>::const_iterator         ConstTextureIterator;
+	typedef std::map<sf::String, std::shared_ptr<sf::Texture>>::reverse_iterator       ReverseTextureIterator;
+	typedef std::map<sf::String, std::shared_ptr<sf::Texture>>::const_reverse_iterator ConstReverseTextureIterator;
+
+	struct TextureRecord
+	{
+		sf::String    alias;
+		sf::String    filePath;  // Empty for textures that cannot be reloaded from a file (images, shared textures); those are never evicted
+		sf::IntRect   area;
+		std::size_t   bytes;
+		std::uint64_t lastUse;
+		std::uint64_t queuedUse; // Stamp of the record's live entry in the eviction heap, 0 if it has none
+		bool          smooth;
+		bool          repeated;
+		bool          pinned;
+		bool          resident;
+	};
 
 	class TextureHandler final
 	{
 	private:
-		std::map<sf::String, sf::Texture> textures;
+		std::map<sf::String, std::shared_ptr<sf::Texture>> textures; // Null while the alias is evicted
+		std::map<sf::String, ResourceHandle>               handles;
+		HandleTable<sf::Texture *>                         slots;
+		std::shared_ptr<TextureCache>                      cache;
+		std::vector<TextureRecord>                         records; // Indexed by handle index
+		std::uint64_t                                      useCounter;
+		std::size_t                                        residentBytes;
+		std::size_t                                        evictions;
+		std::size_t                                        reloads;
+		std::size_t                                        failedReloads;
+		std::vector<std::pair<std::uint64_t, std::uint32_t>> evictionHeap; // (stamp, index), oldest on top; entries are refreshed lazily when popped
+		std::size_t                                        budget;
+		void registerTexture(const sf::String & alias, const std::shared_ptr<sf::Texture> & texture, const sf::String & filePath = sf::String(), const sf::IntRect & area = sf::IntRect())
+		{
+			// Replacing an existing alias keeps its handle and releases this handler's reference to the old texture; other holders
+			// keep theirs, and sprites made from the old texture must be rebound (SpriteHandler and AnimationHandler rebuild theirs)
+			textures[alias] = texture;
+			std::map<sf::String, ResourceHandle>::const_iterator handle = handles.find(alias);
+			std::uint32_t index;
+			if (handle == handles.cend())
+			{
+				ResourceHandle added = slots.insert(texture.get());
+				handles[alias] = added;
+				index = added.index;
+			}
+			else
+			{
+				*slots.get(handle->second) = texture.get();
+				index = handle->second.index;
+			}
+			bool pinned = false;
+			if (records.size() <= index)
+			{
+				records.resize(index + 1);
+			}
+			else if (handle != handles.cend())
+			{
+				pinned = records[index].pinned;
+				residentBytes -= (records[index].resident ? records[index].bytes : 0);
+			}
+			// A fresh record has no heap entry; entries left from the replaced record no longer match its stamp and are dropped when popped
+			TextureRecord record = { alias, filePath, area, textureBytes(*texture), ++useCounter, 0, texture->isSmooth(), texture->isRepeated(), pinned, true };
+			records[index] = record;
+			residentBytes += record.bytes;
+			queueEviction(index);
+			enforceBudget(index);
+		}
+		static std::size_t textureBytes(const sf::Texture & texture)
+		{
+			return static_cast<std::size_t>(texture.getSize().x) * texture.getSize().y * 4;
+		}
+		bool isEvictable(const TextureRecord & record) const
+		{
+			return record.resident && !record.pinned && !record.filePath.isEmpty();
+		}
+		void queueEviction(std::uint32_t index)
+		{
+			TextureRecord & record = records[index];
+			if (isEvictable(record) && record.queuedUse == 0)
+			{
+				record.queuedUse = record.lastUse;
+				if (evictionHeap.size() >= records.size() * 2 + 16)
+				{
+					// Stale entries from replaced or removed textures pile up while the budget is never exceeded; rebuilding from the
+					// records keeps only the live ones, this one included
+					evictionHeap.clear();
+					for (std::uint32_t live = 0; live < records.size(); ++live)
+					{
+						if (records[live].queuedUse != 0)
+						{
+							evictionHeap.push_back(std::make_pair(records[live].queuedUse, live));
+						}
+					}
+					std::make_heap(evictionHeap.begin(), evictionHeap.end(), std::greater<std::pair<std::uint64_t, std::uint32_t>>());
+				}
+				else
+				{
+					evictionHeap.push_back(std::make_pair(record.lastUse, index));
+					std::push_heap(evictionHeap.begin(), evictionHeap.end(), std::greater<std::pair<std::uint64_t, std::uint32_t>>());
+				}
+			}
+		}
+		sf::Texture & touch(std::uint32_t index)
+		{
+			// Marks a texture as used and reloads it if it had been evicted; never evicts anything itself, so references handed out
+			// earlier stay valid until the next call that enforces the budget
+			TextureRecord & record = records[index];
+			record.lastUse = ++useCounter;
+			sf::Texture * & slot = *slots.getAt(index);
+			if (!record.resident && !record.filePath.isEmpty())
+			{
+				std::shared_ptr<sf::Texture> texture = loadTexture(record.filePath, record.alias, record.area);
+				if (!texture)
+				{
+					// Stays evicted, so the next access tries again
+					++failedReloads;
+					return emptyTexture();
+				}
+				texture->setSmooth(record.smooth);
+				texture->setRepeated(record.repeated);
+				textures[record.alias] = texture;
+				slot = texture.get();
+				record.bytes = textureBytes(*texture);
+				record.resident = true;
+				residentBytes += record.bytes;
+				++reloads;
+				queueEviction(index);
+			}
+			return slot ? *slot : emptyTexture();
+		}
+		static sf::Texture & emptyTexture()
+		{
+			// Stands in for textures that are evicted and failed to reload, so callers always get a texture to draw with
+			static sf::Texture empty;
+			return empty;
+		}
+		void enforceBudget(std::uint32_t keep)
+		{
+			// Evicts least recently used, unpinned, file-backed textures until the budget is met or nothing else can go; 'keep' is
+			// set aside rather than evicted, and only this handler's reference is released, so other holders are unaffected
+			std::greater<std::pair<std::uint64_t, std::uint32_t>> later;
+			std::vector<std::pair<std::uint64_t, std::uint32_t>> keptAside;
+			while (residentBytes > budget && !evictionHeap.empty())
+			{
+				std::pair<std::uint64_t, std::uint32_t> oldest = evictionHeap.front();
+				std::pop_heap(evictionHeap.begin(), evictionHeap.end(), later);
+				evictionHeap.pop_back();
+				TextureRecord & record = records[oldest.second];
+				if (record.queuedUse != oldest.first)
+				{
+					// Left over from a replaced, removed or already requeued record
+					continue;
+				}
+				if (!isEvictable(record))
+				{
+					record.queuedUse = 0;
+					continue;
+				}
+				if (record.lastUse != oldest.first)
+				{
+					// Used since it was queued: requeued with its last use
+					record.queuedUse = record.lastUse;
+					evictionHeap.push_back(std::make_pair(record.lastUse, oldest.second));
+					std::push_heap(evictionHeap.begin(), evictionHeap.end(), later);
+					continue;
+				}
+				if (oldest.second == keep)
+				{
+					keptAside.push_back(oldest);
+					continue;
+				}
+				std::shared_ptr<sf::Texture> & texture = textures[record.alias];
+				record.smooth = texture->isSmooth();
+				record.repeated = texture->isRepeated();
+				record.resident = false;
+				record.queuedUse = 0;
+				texture.reset();
+				*slots.getAt(oldest.second) = nullptr;
+				residentBytes -= record.bytes;
+				++evictions;
+			}
+			for (const auto & entry : keptAside)
+			{
+				evictionHeap.push_back(entry);
+				std::push_heap(evictionHeap.begin(), evictionHeap.end(), later);
+			}
+		}
+		std::shared_ptr<sf::Texture> targetTexture(const sf::String & alias) const
+		{
+			// The texture already under 'alias' if nothing else shares it, so reloading the alias happens in place and sprites keep a valid texture
+			ConstTextureIterator texture = textures.find(alias);
+			return texture != textures.cend() && texture->second.use_count() == 1 ? texture->second : std::make_shared<sf::Texture>();
+		}
+		std::shared_ptr<sf::Texture> loadTexture(const sf::String & filePath, const sf::String & alias, const sf::IntRect & area) const
+		{
+			if (cache)
+			{
+				return cache->acquire(filePath, area);
+			}
+			std::shared_ptr<sf::Texture> texture = targetTexture(alias);
+			return texture->loadFromFile(filePath, area) ? texture : nullptr;
+		}
 	public:
 		// Constructors
-		TextureHandler()
+		TextureHandler         () : useCounter(0), residentBytes(0), evictions(0), reloads(0), failedReloads(0), budget(static_cast<std::size_t>(-1))
+		{
+		}
+		explicit TextureHandler(const std::shared_ptr<TextureCache> & textureCache) : cache(textureCache), useCounter(0), residentBytes(0), evictions(0), reloads(0), failedReloads(0), budget(static_cast<std::size_t>(-1))
 		{
 		}
-		TextureHandler(const TextureHandler & rhs) : textures(rhs.textures)
+		TextureHandler         (const TextureHandler & rhs) : textures(rhs.textures), handles(rhs.handles), slots(rhs.slots), cache(rhs.cache), records(rhs.records), useCounter(rhs.useCounter), residentBytes(rhs.residentBytes), evictions(rhs.evictions), reloads(rhs.reloads), failedReloads(rhs.failedReloads), evictionHeap(rhs.evictionHeap), budget(rhs.budget)
 		{
+			// Copies share the same texture objects; nothing is duplicated on the GPU
 		}
 		// Destructor
 		~TextureHandler()
 		{
 		}
+		// Assignment
+		TextureHandler & operator =(const TextureHandler & rhs)
+		{
+			textures = rhs.textures;
+			handles = rhs.handles;
+			slots = rhs.slots;
+			cache = rhs.cache;
+			records = rhs.records;
+			useCounter = rhs.useCounter;
+			residentBytes = rhs.residentBytes;
+			evictions = rhs.evictions;
+			reloads = rhs.reloads;
+			failedReloads = rhs.failedReloads;
+			evictionHeap = rhs.evictionHeap;
+			budget = rhs.budget;
+			return *this;
+		}
 		// Accessors
-		const sf::Texture & getTexture(const sf::String & alias) const
+		const sf::Texture & getTexture(const sf::String & alias)
 		{
 			assert(("The texture requested does not exist", hasTexture(alias)));
-			return textures.at(alias);
+			return getTexture(getHandle(alias));
+		}
+		const sf::Texture & getTexture(const ResourceHandle & handle)
+		{
+			// Counts as a use and reloads the texture if it was evicted, so the object returned may differ from an earlier call;
+			// it stays valid until the next addTexture, removeTexture, setBudget, setPinned(false) or trim call
+			assert(("The texture requested does not exist", hasTexture(handle)));
+			return touch(handle.index);
+		}
+		const sf::Texture * getResidentTexture(const ResourceHandle & handle) const
+		{
+			// Neither counts as a use nor reloads; nullptr for unknown handles and evicted textures
+			return hasTexture(handle) ? *slots.get(handle) : nullptr;
+		}
+		std::shared_ptr<sf::Texture> getSharedTexture(const sf::String & alias)
+		{
+			// Counts as a use like getTexture; nullptr for unknown aliases and textures that could not be reloaded
+			if (hasTexture(alias))
+			{
+				touch(handles.at(alias).index);
+				return textures.at(alias);
+			}
+			return nullptr;
+		}
+		const std::shared_ptr<TextureCache> & getCache() const
+		{
+			return cache;
+		}
+		ResourceHandle      getHandle (const sf::String & alias) const
+		{
+			// Resolve once and keep the handle; an invalid handle is returned for unknown aliases
+			std::map<sf::String, ResourceHandle>::const_iterator handle = handles.find(alias);
+			return handle != handles.cend() ? handle->second : ResourceHandle();
+		}
+		std::size_t         getBudget           () const
+		{
+			return budget;
+		}
+		std::size_t         getResidentBytes    () const
+		{
+			// Estimated at four bytes per texel
+			return residentBytes;
+		}
+		std::size_t         getEvictionCount    () const
+		{
+			return evictions;
+		}
+		std::size_t         getReloadCount      () const
+		{
+			return reloads;
+		}
+		std::size_t         getFailedReloadCount() const
+		{
+			// Evicted textures whose file could not be loaded again; they stay empty until a later access succeeds
+			return failedReloads;
+		}
+		bool                isResident          (const sf::String & alias) const
+		{
+			ResourceHandle handle = getHandle(alias);
+			return hasTexture(handle) && records[handle.index].resident;
+		}
+		bool                isPinned            (const sf::String & alias) const
+		{
+			ResourceHandle handle = getHandle(alias);
+			return hasTexture(handle) && records[handle.index].pinned;
 		}
 		// Mutators
+		void setCache   (const std::shared_ptr<TextureCache> & textureCache)
+		{
+			// Only affects textures loaded from files after the call, reloads of evicted ones included
+			cache = textureCache;
+		}
+		void setBudget  (std::size_t byteBudget)
+		{
+			// File-backed textures beyond the budget are released in least recently used order and reloaded on their next access;
+			// the budget covers the textures this handler references, cached or not, and releasing one only frees its memory
+			// once no other handler or cache holds it
+			budget = byteBudget;
+			enforceBudget(static_cast<std::uint32_t>(records.size()));
+		}
+		void setPinned  (const sf::String & alias, bool pinned)
+		{
+			setPinned(getHandle(alias), pinned);
+		}
+		void setPinned  (const ResourceHandle & handle, bool pinned)
+		{
+			// Pinned textures are never evicted
+			if (hasTexture(handle))
+			{
+				records[handle.index].pinned = pinned;
+				if (pinned)
+				{
+					touch(handle.index);
+				}
+				else
+				{
+					queueEviction(handle.index);
+					enforceBudget(static_cast<std::uint32_t>(records.size()));
+				}
+			}
+		}
 		void setRepeated(const sf::String & alias, bool repeated)
 		{
-			if (hasTexture(alias))
+			setRepeated(getHandle(alias), repeated);
+		}
+		void setRepeated(const ResourceHandle & handle, bool repeated)
+		{
+			// Evicted textures get the setting when they are reloaded
+			if (hasTexture(handle))
 			{
-				textures.at(alias).setRepeated(repeated);
+				records[handle.index].repeated = repeated;
+				if (*slots.get(handle))
+				{
+					(*slots.get(handle))->setRepeated(repeated);
+				}
 			}
 		}
 		void setSmooth  (const sf::String & alias, bool smooth)
 		{
-			if (hasTexture(alias))
+			setSmooth(getHandle(alias), smooth);
+		}
+		void setSmooth  (const ResourceHandle & handle, bool smooth)
+		{
+			if (hasTexture(handle))
 			{
-				textures.at(alias).setSmooth(smooth);
+				records[handle.index].smooth = smooth;
+				if (*slots.get(handle))
+				{
+					(*slots.get(handle))->setSmooth(smooth);
+				}
 			}
 		}
 		// Utilities
+		void      trim         ()
+		{
+			// Evicts down to the budget; textures reloaded by getTexture since the last eviction may have pushed it over
+			enforceBudget(static_cast<std::uint32_t>(records.size()));
+		}
 		bool      addTexture   (const sf::String & filePath, const sf::String & alias, const sf::IntRect & area = sf::IntRect())
 		{
-			sf::Texture texture;
-			if (texture.loadFromFile(filePath, area))
+			std::shared_ptr<sf::Texture> texture = loadTexture(filePath, alias, area);
+			if (texture)
 			{
-				textures[alias] = texture;
+				// Cached textures are budgeted like the others; evicting one releases this handler's reference, and it is reloaded
+				// through the cache
+				registerTexture(alias, texture, filePath, area);
 				return true;
 			}
 			return false;
 		}
 		bool      addTexture   (const sf::String & filePath, const sf::String & alias, bool smooth, bool repeated, const sf::IntRect & area = sf::IntRect())
 		{
-			sf::Texture texture;
-			if (texture.loadFromFile(filePath, area))
+			// With a cache, the flags apply to the shared texture and so to every handler using it
+			std::shared_ptr<sf::Texture> texture = loadTexture(filePath, alias, area);
+			if (texture)
 			{
-				texture.setRepeated(repeated);
-				texture.setSmooth(smooth);
-				textures[alias] = texture;
+				texture->setRepeated(repeated);
+				texture->setSmooth(smooth);
+				registerTexture(alias, texture, filePath, area);
 				return true;
 			}
 			return false;
 		}
 		bool      addTexture   (const sf::Image & image, const sf::String & alias, const sf::IntRect & area = sf::IntRect())
 		{
-			sf::Texture texture;
-			if (texture.loadFromImage(image, area))
+			std::shared_ptr<sf::Texture> texture = targetTexture(alias);
+			if (texture->loadFromImage(image, area))
 			{
-				textures[alias] = texture;
+				registerTexture(alias, texture);
 				return true;
 			}
 			return false;
 		}
 		bool      addTexture   (const sf::Image & image, const sf::String & alias, bool smooth, bool repeated, const sf::IntRect & area = sf::IntRect())
 		{
-			sf::Texture texture;
-			if (texture.loadFromImage(image, area))
+			std::shared_ptr<sf::Texture> texture = targetTexture(alias);
+			if (texture->loadFromImage(image, area))
+			{
+				texture->setRepeated(repeated);
+				texture->setSmooth(smooth);
+				registerTexture(alias, texture);
+				return true;
+			}
+			return false;
+		}
+		bool      addTexture   (const std::shared_ptr<sf::Texture> & texture, const sf::String & alias)
+		{
+			// Shares a texture owned elsewhere (another handler, a cache, ...)
+			if (texture)
 			{
-				texture.setRepeated(repeated);
-				texture.setSmooth(smooth);
-				textures[alias] = texture;
+				registerTexture(alias, texture);
 				return true;
 			}
 			return false;
@@ -100,20 +458,34 @@ namespace sfext
 		{
 			return textures.find(alias) != textures.cend();
 		}
+		bool      hasTexture   (const ResourceHandle & handle) const
+		{
+			return slots.contains(handle);
+		}
 		bool      removeTexture(const sf::String & alias)
 		{
 			ConstTextureIterator texture = textures.find(alias);
 			if (texture != textures.cend())
 			{
+				TextureRecord & record = records[handles.at(alias).index];
+				if (record.resident)
+				{
+					residentBytes -= record.bytes;
+					record.resident = false;
+				}
+				// Any heap entry left for the record is dropped as stale
+				record.queuedUse = 0;
+				slots.erase(handles.at(alias));
+				handles.erase(alias);
 				textures.erase(texture);
 				return true;
 			}
 			return false;
 		}
-		sf::Image copyToImage  (const sf::String & alias) const
+		sf::Image copyToImage  (const sf::String & alias)
 		{
 			assert(("The texture requested does not exist", hasTexture(alias)));
-			return textures.at(alias).copyToImage();
+			return getTexture(alias).copyToImage();
 		}
 		// Iterators
 		TextureIterator             begin  ()
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/String.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "ThreadPool.hpp"
+#include "TextureHandler.hpp"
+
+namespace sfext
+{
+	class TextureLoader final
+	{
+	private:
+		struct Request
+		{
+			sf::String                          filePath;
+			sf::String                          alias;
+			sf::IntRect                         area;
+			bool                                applyFlags;
+			bool                                smooth;
+			bool                                repeated;
+			sf::Image                           image;
+			std::shared_ptr<std::promise<bool>> uploaded;
+		};
+		std::deque<std::shared_ptr<Request>> decoded;
+		std::mutex                           mutex;
+		std::condition_variable              decodeFinished;
+		std::atomic<std::size_t>             decoding;
+		std::atomic<bool>                    stopping; // Set by the destructor so queued decodes are skipped
+		oak::ThreadPool                      pool; // Declared last so workers are joined before the queue goes away
+		std::shared_future<bool> submit(const std::shared_ptr<Request> & request)
+		{
+			request->uploaded = std::make_shared<std::promise<bool>>();
+			std::shared_future<bool> result = request->uploaded->get_future().share();
+			++decoding;
+			pool.enqueue([this, request]
+			{
+				bool loaded = !stopping && request->image.loadFromFile(request->filePath);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (loaded)
+					{
+						decoded.push_back(request);
+					}
+					else
+					{
+						request->uploaded->set_value(false);
+					}
+					--decoding;
+				}
+				decodeFinished.notify_all();
+			});
+			return result;
+		}
+	public:
+		// Constructors
+		explicit TextureLoader(std::size_t threadCount = std::thread::hardware_concurrency()) : decoding(0), stopping(false), pool(threadCount)
+		{
+		}
+		TextureLoader(const TextureLoader & rhs) = delete;
+		// Destructor
+		~TextureLoader()
+		{
+			// Futures of requests that will never be uploaded become false rather than throwing std::future_error (broken_promise)
+			stopping = true;
+			waitForDecodes();
+			for (const std::shared_ptr<Request> & request : decoded)
+			{
+				request->uploaded->set_value(false);
+			}
+		}
+		// Accessors
+		std::size_t getDecodingCount() const
+		{
+			// Files queued or being decoded on the worker pool
+			return decoding;
+		}
+		std::size_t getDecodedCount ()
+		{
+			// Images decoded and waiting for pumpUploads
+			std::lock_guard<std::mutex> lock(mutex);
+			return decoded.size();
+		}
+		// Utilities
+		std::shared_future<bool> queue          (const sf::String & filePath, const sf::String & alias, const sf::IntRect & area = sf::IntRect())
+		{
+			// Returns immediately; the future becomes true once the texture has been uploaded by pumpUploads
+			std::shared_ptr<Request> request = std::make_shared<Request>();
+			request->filePath = filePath;
+			request->alias = alias;
+			request->area = area;
+			request->applyFlags = false;
+			request->smooth = false;
+			request->repeated = false;
+			return submit(request);
+		}
+		std::shared_future<bool> queue          (const sf::String & filePath, const sf::String & alias, bool smooth, bool repeated, const sf::IntRect & area = sf::IntRect())
+		{
+			std::shared_ptr<Request> request = std::make_shared<Request>();
+			request->filePath = filePath;
+			request->alias = alias;
+			request->area = area;
+			request->applyFlags = true;
+			request->smooth = smooth;
+			request->repeated = repeated;
+			return submit(request);
+		}
+		void                     waitForDecodes ()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			decodeFinished.wait(lock, [this]
+			{
+				return decoding == 0;
+			});
+		}
+		std::size_t              pumpUploads    (TextureHandler & textureHandler, const sf::Time & budget)
+		{
+			// Must be called from the thread that owns the OpenGL context
+			return pumpUploads(budget, [&textureHandler](const sf::String & alias, const sf::Image & image, const sf::IntRect & area, bool applyFlags, bool smooth, bool repeated)
+			{
+				return applyFlags ? textureHandler.addTexture(image, alias, smooth, repeated, area) : textureHandler.addTexture(image, alias, area);
+			});
+		}
+		std::size_t              pumpUploads    (const sf::Time & budget, const std::function<bool(const sf::String &, const sf::Image &, const sf::IntRect &, bool, bool, bool)> & upload)
+		{
+			// Hands decoded images to 'upload' until the budget is spent; at least one image is processed per call so loading always progresses
+			// If 'upload' throws, the request's future holds the exception and it is rethrown here; the remaining requests stay queued
+			sf::Clock clock;
+			std::size_t uploaded = 0;
+			do
+			{
+				std::shared_ptr<Request> request;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (decoded.empty())
+					{
+						break;
+					}
+					request = decoded.front();
+					decoded.pop_front();
+				}
+				bool result = false;
+				try
+				{
+					result = upload(request->alias, request->image, request->area, request->applyFlags, request->smooth, request->repeated);
+				}
+				catch (...)
+				{
+					request->uploaded->set_exception(std::current_exception());
+					throw;
+				}
+				request->uploaded->set_value(result);
+				++uploaded;
+			}
+			while (clock.getElapsedTime() < budget);
+			return uploaded;
+		}
+	};
+}
\ No newline at end of file
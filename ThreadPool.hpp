@@ -0,0 +1,188 @@
+#pragma once
+
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+namespace oak
+{
+	class ThreadPool final
+	{
+	private:
+		std::vector<std::thread>          workers;
+		std::deque<std::function<void()>> tasks;
+		std::mutex                        mutex;
+		std::condition_variable           condition;
+		bool                              stopping;
+		// Shared between parallelFor's caller and the helper tasks it queues, which may start after the call has returned
+		struct RangeState
+		{
+			std::atomic<std::size_t> next;
+			std::size_t              count;
+			std::size_t              rangeSize;
+			std::size_t              ranges;
+			std::size_t              finished;
+			std::exception_ptr       error;
+			std::mutex               mutex;
+			std::condition_variable  done;
+		};
+		template <class F>
+		static void runRanges(RangeState & state, F & function)
+		{
+			// Claims ranges until none are left; 'function' is only touched after a claim succeeds, while the caller still waits
+			for (std::size_t range = state.next++; range < state.ranges; range = state.next++)
+			{
+				std::size_t first = range * state.rangeSize;
+				std::exception_ptr error;
+				try
+				{
+					function(first, std::min(state.count, first + state.rangeSize));
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if (error && !state.error)
+				{
+					state.error = error;
+				}
+				if (++state.finished == state.ranges)
+				{
+					state.done.notify_all();
+				}
+			}
+		}
+		void work()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [this]
+					{
+						return stopping || !tasks.empty();
+					});
+					if (tasks.empty()) // Only reached when stopping
+					{
+						return;
+					}
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+				task();
+			}
+		}
+	public:
+		// Constructors
+		explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency()) : stopping(false)
+		{
+			threadCount = (threadCount ? threadCount : 1);
+			for (std::size_t i = 0; i < threadCount; ++i)
+			{
+				workers.push_back(std::thread(&ThreadPool::work, this));
+			}
+		}
+		ThreadPool(const ThreadPool & rhs) = delete;
+		// Destructor
+		~ThreadPool()
+		{
+			// Tasks already queued are still run before the workers exit
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			condition.notify_all();
+			for (std::thread & worker : workers)
+			{
+				worker.join();
+			}
+		}
+		// Accessors
+		std::size_t getThreadCount() const
+		{
+			return workers.size();
+		}
+		// Utilities
+		template <class F>
+		std::future<typename std::result_of<F()>::type> enqueue(F function)
+		{
+			auto task = std::make_shared<std::packaged_task<typename std::result_of<F()>::type()>>(std::move(function));
+			std::future<typename std::result_of<F()>::type> result = task->get_future();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tasks.push_back([task]
+				{
+					(*task)();
+				});
+			}
+			condition.notify_one();
+			return result;
+		}
+		template <class F>
+		void parallelFor(std::size_t count, std::size_t minimumRange, F function)
+		{
+			// Calls function(first, last) over contiguous ranges covering [0, count), at most one per worker plus one, and returns
+			// once every range is done. The calling thread works through the ranges too, taking any a worker has not started, so
+			// a pool busy with other tasks slows the call down to single-threaded speed but never stalls it
+			if (count == 0)
+			{
+				return;
+			}
+			std::shared_ptr<RangeState> state = std::make_shared<RangeState>();
+			state->ranges = std::min(workers.size() + 1, std::max<std::size_t>(1, count / std::max<std::size_t>(1, minimumRange)));
+			state->rangeSize = (count + state->ranges - 1) / state->ranges;
+			state->ranges = (count + state->rangeSize - 1) / state->rangeSize;
+			state->count = count;
+			state->next = 0;
+			state->finished = 0;
+			F * shared = &function;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				for (std::size_t helper = 1; helper < state->ranges; ++helper)
+				{
+					tasks.push_back([state, shared]
+					{
+						runRanges(*state, *shared);
+					});
+				}
+			}
+			condition.notify_all();
+			runRanges(*state, function);
+			// Ranges claimed by workers may still be running and referencing 'function'
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->done.wait(lock, [&state]
+			{
+				return state->finished == state->ranges;
+			});
+			if (state->error)
+			{
+				std::rethrow_exception(state->error);
+			}
+		}
+		// Static Functions
+		static ThreadPool & getShared()
+		{
+			// Process-wide pool for short CPU-bound jobs such as building batch vertices; created on first use
+			// Long-running work (font prewarming, decoding) belongs on getBackground() so it never delays these
+			static ThreadPool pool;
+			return pool;
+		}
+		static ThreadPool & getBackground()
+		{
+			// Process-wide pool for background jobs that may run for many frames; half the cores, created on first use
+			static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency() / 2));
+			return pool;
+		}
+	};
+}
\ No newline at end of file
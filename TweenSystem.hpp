@@ -0,0 +1,343 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+#include <SFML/System/Time.hpp>
+
+#include "Tweener.hpp"
+#include "Random.hpp"
+
+namespace oak
+{
+	struct TweenHandle
+	{
+		std::uint32_t index;
+		std::uint32_t generation; // Never 0 for a handle that was issued, so a default handle is always invalid
+		TweenHandle() : index(0), generation(0)
+		{
+		}
+		TweenHandle(std::uint32_t i, std::uint32_t gen) : index(i), generation(gen)
+		{
+		}
+		bool isValid() const
+		{
+			return generation != 0;
+		}
+		bool operator ==(const TweenHandle & rhs) const
+		{
+			return index == rhs.index && generation == rhs.generation;
+		}
+		bool operator !=(const TweenHandle & rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	// Every active tween in structure of arrays form, one group per (style, period), advanced with one flat loop per group.
+	// Tweens write into values owned by the system, addressed by index, instead of through bound references.
+	class TweenSystem final
+	{
+	private:
+		struct Group
+		{
+			// Packed: the tweens of a group are always [0, size)
+			std::vector<float>         times;            // Seconds since the tween started
+			std::vector<float>         inverseCycles;    // 1 / (duration * cycle length), so the loops never divide
+			std::vector<float>         starts;
+			std::vector<float>         ranges;           // finish - start
+			std::vector<float>         results;
+			std::vector<std::uint32_t> targets;          // Index into 'values'
+			std::vector<std::uint32_t> records;          // Index into 'records', to fix handles when a tween moves
+		};
+		struct Record
+		{
+			std::uint32_t group;
+			std::uint32_t position;   // In the group's arrays
+			std::uint32_t generation;
+			bool          active;
+		};
+		static const std::size_t   GROUP_COUNT = (static_cast<std::size_t>(TweenerStyle::Random) + 1) * 3;
+		std::vector<Group>         groups;
+		std::vector<Record>        records;
+		std::vector<std::uint32_t> freeRecords; // Finished and stopped tweens, reused before 'records' grows
+		std::vector<float>         values;
+		std::vector<std::uint32_t> valueTweens; // Record + 1 of the tween writing each value, 0 for none
+		std::size_t                activeCount;
+		template <int Style, int Period>
+		static void advance(Group & group, float seconds)
+		{
+			// Style and period are constants here, so the curve's switch folds away. The clamp, the fractional part and the curve
+			// are separate passes over 'results', since GCC leaves control flow in a loop that clamps and then computes with the
+			// result. With GCC 12 at -O3 every pass vectorizes for Constant, Linear, Quadratic, Exponential and Random;
+			// Sinusoidal (std::cos) and Circular (std::sqrt, which may set errno) keep a scalar curve pass
+			std::size_t size = group.times.size();
+			float * times = group.times.data();
+			const float * inverseCycles = group.inverseCycles.data();
+			const float * starts = group.starts.data();
+			const float * ranges = group.ranges.data();
+			float * results = group.results.data();
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				times[i] += seconds;
+			}
+			// Repeating phases are clamped to 2^23 cycles: floats that large are whole numbers, so their fractional part is still 0
+			// and the conversion below stays in range
+			float lowest = (static_cast<TweenerPeriod>(Period) == TweenerPeriod::Single) ? 0.f : -8388608.f;
+			float highest = (static_cast<TweenerPeriod>(Period) == TweenerPeriod::Single) ? 1.f : 8388608.f;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				results[i] = std::min(std::max(times[i] * inverseCycles[i], lowest), highest);
+			}
+			if (static_cast<TweenerPeriod>(Period) != TweenerPeriod::Single)
+			{
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					// Fractional part by truncation, since std::floor has no SSE2 form
+					float fraction = results[i] - static_cast<float>(static_cast<std::int32_t>(results[i]));
+					results[i] = fraction + static_cast<float>(fraction < 0.f);
+				}
+			}
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				results[i] = starts[i] + ranges[i] * EasingTable::evaluate(static_cast<TweenerStyle>(Style), static_cast<TweenerPeriod>(Period), results[i]);
+			}
+		}
+		template <int Style>
+		static void advance(Group & group, float seconds, TweenerPeriod period)
+		{
+			switch (period)
+			{
+			case TweenerPeriod::Single:
+				{
+					advance<Style, static_cast<int>(TweenerPeriod::Single)>(group, seconds);
+					break;
+				}
+			case TweenerPeriod::BackAndForth:
+				{
+					advance<Style, static_cast<int>(TweenerPeriod::BackAndForth)>(group, seconds);
+					break;
+				}
+			case TweenerPeriod::WrapAround:
+				{
+					advance<Style, static_cast<int>(TweenerPeriod::WrapAround)>(group, seconds);
+					break;
+				}
+			}
+		}
+		static std::uint32_t groupOf(TweenerStyle style, TweenerPeriod period)
+		{
+			return static_cast<std::uint32_t>(style) * 3 + static_cast<std::uint32_t>(period);
+		}
+		void release(std::uint32_t record)
+		{
+			// Swaps the group's last tween into the freed position and recycles the record
+			Record & released = records[record];
+			Group & group = groups[released.group];
+			std::uint32_t last = static_cast<std::uint32_t>(group.times.size() - 1);
+			std::uint32_t position = released.position;
+			valueTweens[group.targets[position]] = 0;
+			group.times[position] = group.times[last];
+			group.inverseCycles[position] = group.inverseCycles[last];
+			group.starts[position] = group.starts[last];
+			group.ranges[position] = group.ranges[last];
+			group.results[position] = group.results[last];
+			group.targets[position] = group.targets[last];
+			group.records[position] = group.records[last];
+			records[group.records[position]].position = position;
+			group.times.pop_back();
+			group.inverseCycles.pop_back();
+			group.starts.pop_back();
+			group.ranges.pop_back();
+			group.results.pop_back();
+			group.targets.pop_back();
+			group.records.pop_back();
+			released.active = false;
+			released.generation = (released.generation + 1 ? released.generation + 1 : 1);
+			freeRecords.push_back(record);
+			--activeCount;
+		}
+	public:
+		// Constructors
+		TweenSystem() : groups(GROUP_COUNT), activeCount(0)
+		{
+		}
+		TweenSystem(const TweenSystem & rhs) : groups(rhs.groups), records(rhs.records), freeRecords(rhs.freeRecords), values(rhs.values), valueTweens(rhs.valueTweens), activeCount(rhs.activeCount)
+		{
+		}
+		// Destructor
+		~TweenSystem()
+		{
+		}
+		// Accessors
+		std::size_t                getActiveCount() const
+		{
+			return activeCount;
+		}
+		std::size_t                getValueCount () const
+		{
+			return values.size();
+		}
+		float                      getValue      (std::uint32_t value) const
+		{
+			assert(("The value requested does not exist", value < values.size()));
+			return values[value];
+		}
+		const std::vector<float> & getValues     () const
+		{
+			return values;
+		}
+		bool                       isActive      (const TweenHandle & tween) const
+		{
+			return tween.index < records.size() && records[tween.index].active && records[tween.index].generation == tween.generation;
+		}
+		// Mutators
+		void setValue(std::uint32_t value, float val)
+		{
+			// A tween still writing to 'value' overwrites this on the next update
+			assert(("The value requested does not exist", value < values.size()));
+			values[value] = val;
+		}
+		// Utilities
+		std::uint32_t addValue(float initial = 0.f)
+		{
+			// Returns the index tweens write to; values live as long as the system
+			values.push_back(initial);
+			valueTweens.push_back(0);
+			return static_cast<std::uint32_t>(values.size() - 1);
+		}
+		TweenHandle   play    (std::uint32_t value, float start, float finish, const sf::Time & duration, TweenerStyle style = TweenerStyle::Linear, TweenerPeriod period = TweenerPeriod::Single)
+		{
+			// Starts tweening 'value' from 'start' to 'finish'; the value is set to 'start' right away
+			// A value has at most one tween: one still writing to 'value' is stopped first, so results never depend on the order groups are updated in
+			assert(("The value requested does not exist", value < values.size()));
+			if (valueTweens[value])
+			{
+				release(valueTweens[value] - 1);
+			}
+			std::uint32_t record;
+			if (!freeRecords.empty())
+			{
+				record = freeRecords.back();
+				freeRecords.pop_back();
+			}
+			else
+			{
+				record = static_cast<std::uint32_t>(records.size());
+				Record added = { 0, 0, 1, false };
+				records.push_back(added);
+			}
+			float cycleLength = (period == TweenerPeriod::BackAndForth && (style == TweenerStyle::Linear || style == TweenerStyle::Quadratic || style == TweenerStyle::Sinusoidal)) ? 2.f : 1.f;
+			float seconds = duration.asSeconds() * cycleLength;
+			// A zero duration jumps straight to the end of a single tween and holds repeating ones at their start
+			float inverseCycle = seconds > 0.f ? 1.f / seconds : (period == TweenerPeriod::Single ? 1e30f : 0.f);
+			Group & group = groups[groupOf(style, period)];
+			records[record].group = groupOf(style, period);
+			records[record].position = static_cast<std::uint32_t>(group.times.size());
+			records[record].active = true;
+			group.times.push_back(0.f);
+			group.inverseCycles.push_back(inverseCycle);
+			group.starts.push_back(start);
+			group.ranges.push_back(finish - start);
+			group.results.push_back(start);
+			group.targets.push_back(value);
+			group.records.push_back(record);
+			values[value] = start;
+			valueTweens[value] = record + 1;
+			++activeCount;
+			return TweenHandle(record, records[record].generation);
+		}
+		bool          stop    (const TweenHandle & tween)
+		{
+			// The value keeps whatever the tween last wrote
+			if (isActive(tween))
+			{
+				release(tween.index);
+				return true;
+			}
+			return false;
+		}
+		void          clear   ()
+		{
+			for (std::uint32_t i = 0; i < records.size(); ++i)
+			{
+				if (records[i].active)
+				{
+					release(i);
+				}
+			}
+		}
+		void          update  (const sf::Time & elapsed)
+		{
+			// Single tweens that reach their duration write their final value and are recycled; the others run until stopped
+			float seconds = elapsed.asSeconds();
+			for (std::uint32_t index = 0; index < GROUP_COUNT; ++index)
+			{
+				Group & group = groups[index];
+				if (group.times.empty())
+				{
+					continue;
+				}
+				TweenerPeriod period = static_cast<TweenerPeriod>(index % 3);
+				switch (static_cast<TweenerStyle>(index / 3))
+				{
+				case TweenerStyle::Linear:
+					{
+						advance<static_cast<int>(TweenerStyle::Linear)>(group, seconds, period);
+						break;
+					}
+				case TweenerStyle::Quadratic:
+					{
+						advance<static_cast<int>(TweenerStyle::Quadratic)>(group, seconds, period);
+						break;
+					}
+				case TweenerStyle::Sinusoidal:
+					{
+						advance<static_cast<int>(TweenerStyle::Sinusoidal)>(group, seconds, period);
+						break;
+					}
+				case TweenerStyle::Circular:
+					{
+						advance<static_cast<int>(TweenerStyle::Circular)>(group, seconds, period);
+						break;
+					}
+				case TweenerStyle::Random:
+					{
+						// Drawn again every update, as Tweener does
+						for (std::size_t i = 0; i < group.times.size(); ++i)
+						{
+							group.times[i] += seconds;
+							group.results[i] = static_cast<float>(randomReal(group.starts[i], group.starts[i] + group.ranges[i]));
+						}
+						break;
+					}
+				default:
+					{
+						// Constant and Exponential hold their start value
+						advance<static_cast<int>(TweenerStyle::Constant)>(group, seconds, period);
+						break;
+					}
+				}
+				// Scattered separately so the loops above only touch contiguous arrays
+				for (std::size_t i = 0; i < group.times.size(); ++i)
+				{
+					values[group.targets[i]] = group.results[i];
+				}
+				if (period == TweenerPeriod::Single)
+				{
+					// Backwards, so the tween swapped into a released position has already been checked
+					for (std::size_t i = group.times.size(); i-- > 0;)
+					{
+						if (group.times[i] * group.inverseCycles[i] >= 1.f)
+						{
+							release(group.records[i]);
+						}
+					}
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <SFML/System/Clock.hpp>
 
 #include "VectorMath.hpp"
 #include "Random.hpp"
@@ -26,6 +30,165 @@ namespace oak
 		WrapAround
 	};
 
+	// One (style, period) curve sampled over a cycle, as the fraction of the way from start to finish
+	class EasingTable final
+	{
+	private:
+		std::vector<float> samples;     // At evenly spaced points of the cycle, both ends included
+		float              cycleLength; // In durations: back and forth curves take two to return to their start
+		bool               repeats;
+	public:
+		// Constructors
+		EasingTable(TweenerStyle style, TweenerPeriod period, std::size_t resolution = 512) : samples(std::max<std::size_t>(resolution, 2) + 1), cycleLength(1.f), repeats(period != TweenerPeriod::Single)
+		{
+			if (period == TweenerPeriod::BackAndForth && (style == TweenerStyle::Linear || style == TweenerStyle::Quadratic || style == TweenerStyle::Sinusoidal))
+			{
+				cycleLength = 2.f;
+			}
+			for (std::size_t i = 0; i < samples.size(); ++i)
+			{
+				samples[i] = evaluate(style, period, static_cast<float>(i) / static_cast<float>(samples.size() - 1));
+			}
+		}
+		EasingTable(const EasingTable & rhs) : samples(rhs.samples), cycleLength(rhs.cycleLength), repeats(rhs.repeats)
+		{
+		}
+		// Destructor
+		~EasingTable()
+		{
+		}
+		// Accessors
+		std::size_t getResolution() const
+		{
+			return samples.size() - 1;
+		}
+		// Utilities
+		float sample(float phase) const
+		{
+			// Linear interpolation between the two samples around 'phase', clamped to [0, 1]
+			float position = std::min(std::max(phase, 0.f), 1.f) * static_cast<float>(samples.size() - 1);
+			std::size_t index = std::min(static_cast<std::size_t>(position), samples.size() - 2);
+			return samples[index] + (samples[index + 1] - samples[index]) * (position - static_cast<float>(index));
+		}
+		float at    (float time, float duration) const
+		{
+			// Same fraction Tweener::get computes for 'time' seconds into a tween lasting 'duration' seconds
+			// Negative times wrap into the cycle, where the analytic repeating curves leave the range instead
+			if (!(duration > 0.f))
+			{
+				return repeats ? samples.front() : samples.back();
+			}
+			if (!repeats)
+			{
+				return sample(time / duration);
+			}
+			float cycle = duration * cycleLength;
+			float phase = std::fmod(time, cycle) / cycle;
+			return sample(phase < 0.f ? phase + 1.f : phase);
+		}
+		// Static Functions
+		static float               evaluate(TweenerStyle style, TweenerPeriod period, float phase)
+		{
+			// Analytic curves, written as functions of the phase within one cycle; styles without a curve (Constant, Exponential, Random) stay at the start
+			bool backAndForth = period == TweenerPeriod::BackAndForth;
+			switch (style)
+			{
+			case TweenerStyle::Linear:
+				{
+					// 1 - |2p - 1| rises over the first half and falls over the second without a branch
+					return backAndForth ? 1.f - std::fabs(2.f * phase - 1.f) : phase;
+				}
+			case TweenerStyle::Quadratic:
+				{
+					float rise = backAndForth ? 1.f - std::fabs(2.f * phase - 1.f) : phase;
+					return rise * rise;
+				}
+			case TweenerStyle::Sinusoidal:
+				{
+					return .5f - .5f * std::cos((backAndForth ? 2.f : 1.f) * 3.141592f * phase);
+				}
+			case TweenerStyle::Circular:
+				{
+					float offset = 1.f - 2.f * phase;
+					return std::sqrt(std::max(0.f, 1.f - offset * offset));
+				}
+			default:
+				{
+					return 0.f;
+				}
+			}
+		}
+		static const EasingTable & get     (TweenerStyle style, TweenerPeriod period)
+		{
+			// Shared tables for every (style, period), built on first use
+			static const std::vector<EasingTable> tables = []
+			{
+				std::vector<EasingTable> built;
+				for (int i = 0; i <= static_cast<int>(TweenerStyle::Random); ++i)
+				{
+					for (int j = 0; j <= static_cast<int>(TweenerPeriod::WrapAround); ++j)
+					{
+						built.push_back(EasingTable(static_cast<TweenerStyle>(i), static_cast<TweenerPeriod>(j)));
+					}
+				}
+				return built;
+			}();
+			return tables[static_cast<std::size_t>(style) * 3 + static_cast<std::size_t>(period)];
+		}
+	};
+
+	struct EasingReport
+	{
+		TweenerStyle  style;
+		TweenerPeriod period;
+		float         maximumError; // Absolute, as a fraction of the distance from start to finish
+		float         meanError;
+		float         analyticNanoseconds; // Per evaluation
+		float         tableNanoseconds;
+	};
+
+	// Compares the shared tables with the analytic curves for every (style, period) except Random, which has no curve
+	inline std::vector<EasingReport> reportEasingTables(std::size_t evaluations = 1 << 16)
+	{
+		std::vector<EasingReport> report;
+		evaluations = std::max<std::size_t>(evaluations, 2);
+		volatile float sink = 0.f; // Keeps the timed loops from being optimized away
+		for (int i = 0; i < static_cast<int>(TweenerStyle::Random); ++i)
+		{
+			for (int j = 0; j <= static_cast<int>(TweenerPeriod::WrapAround); ++j)
+			{
+				EasingReport entry = { static_cast<TweenerStyle>(i), static_cast<TweenerPeriod>(j), 0.f, 0.f, 0.f, 0.f };
+				const EasingTable & table = EasingTable::get(entry.style, entry.period);
+				double totalError = 0.0;
+				for (std::size_t k = 0; k < evaluations; ++k)
+				{
+					// Offset by half a step so most phases fall between samples
+					float phase = (static_cast<float>(k) + .5f) / static_cast<float>(evaluations);
+					float error = std::fabs(table.sample(phase) - EasingTable::evaluate(entry.style, entry.period, phase));
+					entry.maximumError = std::max(entry.maximumError, error);
+					totalError += error;
+				}
+				entry.meanError = static_cast<float>(totalError / static_cast<double>(evaluations));
+				float step = 1.f / static_cast<float>(evaluations);
+				float sum = 0.f;
+				sf::Clock clock;
+				for (std::size_t k = 0; k < evaluations; ++k)
+				{
+					sum += EasingTable::evaluate(entry.style, entry.period, static_cast<float>(k) * step);
+				}
+				entry.analyticNanoseconds = clock.restart().asMicroseconds() * 1000.f / static_cast<float>(evaluations);
+				for (std::size_t k = 0; k < evaluations; ++k)
+				{
+					sum += table.sample(static_cast<float>(k) * step);
+				}
+				entry.tableNanoseconds = clock.restart().asMicroseconds() * 1000.f / static_cast<float>(evaluations);
+				sink = sink + sum;
+				report.push_back(entry);
+			}
+		}
+		return report;
+	}
+
 	class Tweener final 
 	{
 	private:
@@ -35,12 +198,13 @@ namespace oak
 		TweenerStyle style;
 		TweenerPeriod period;
 		sf::Time duration;
+		bool lookupTable; // Evaluate the curve from the shared EasingTable instead of analytically
 	public:
 		// Constructors
-		Tweener() : clock(false), start(0.f), finish(0.f), style(TweenerStyle::Linear), period(TweenerPeriod::Single), duration(sf::Time::Zero)
+		Tweener() : clock(false), start(0.f), finish(0.f), style(TweenerStyle::Linear), period(TweenerPeriod::Single), duration(sf::Time::Zero), lookupTable(false)
 		{
 		}
-		Tweener(float startVal, float finishVal, const sf::Time & dur) : clock(false), start(startVal), finish(finishVal), style(TweenerStyle::Linear), period(TweenerPeriod::Single), duration(dur)
+		Tweener(float startVal, float finishVal, const sf::Time & dur) : clock(false), start(startVal), finish(finishVal), style(TweenerStyle::Linear), period(TweenerPeriod::Single), duration(dur), lookupTable(false)
 		{
 		}
 		// Destructor
@@ -68,30 +232,43 @@ namespace oak
 		{
 			clock.setModifier(scale);
 		}
+		void setLookupTable(bool enabled)
+		{
+			// Trades a small error (see reportEasingTables; at most about 2% at the ends of Circular curves) for a table lookup instead of std::pow, std::cos or std::sqrt; Random is unaffected
+			lookupTable = enabled;
+		}
 		// Accessors
-		TweenerStyle  getStyle      () const
+		TweenerStyle  getStyle       () const
 		{
 			return style;
 		}
-		TweenerPeriod getPeriod     () const
+		TweenerPeriod getPeriod      () const
 		{
 			return period;
 		}
-		sf::Time      getDuration   () const
+		sf::Time      getDuration    () const
 		{
 			return duration;
 		}
-		sf::Time      getElapsedTime() const
+		sf::Time      getElapsedTime () const
 		{
 			return clock.getElapsedTime();
 		}
-		float         getTimeScale  () const
+		float         getTimeScale   () const
 		{
 			return clock.getModifier();
 		}
+		bool          usesLookupTable() const
+		{
+			return lookupTable;
+		}
 		// Utilities
 		float  get  () const
 		{
+			if (lookupTable && style != TweenerStyle::Random)
+			{
+				return start + (finish - start) * EasingTable::get(style, period).at(clock.getElapsedTime().asSeconds(), duration.asSeconds());
+			}
 			switch (style)
 			{
 			case TweenerStyle::Constant:
@@ -271,12 +448,13 @@ namespace oak
 		TweenerPeriod period;
 		sf::Time time;
 		sf::Time duration;
+		bool lookupTable;
 	public:
 		// Constructors
-		DiscreteTweener(float & boundValue) : reference(boundValue), start(0), finish(0), style(TweenerStyle::Linear), period(TweenerPeriod::Single), time(sf::Time::Zero), duration(sf::seconds(1.f))
+		DiscreteTweener(float & boundValue) : reference(boundValue), start(0), finish(0), style(TweenerStyle::Linear), period(TweenerPeriod::Single), time(sf::Time::Zero), duration(sf::seconds(1.f)), lookupTable(false)
 		{
 		}
-		DiscreteTweener(float & boundValue, double startVal, double finishVal, const sf::Time & dur) : reference(boundValue), start(startVal), finish(finishVal), style(TweenerStyle::Linear), period(TweenerPeriod::Single), time(sf::Time::Zero), duration(dur)
+		DiscreteTweener(float & boundValue, double startVal, double finishVal, const sf::Time & dur) : reference(boundValue), start(startVal), finish(finishVal), style(TweenerStyle::Linear), period(TweenerPeriod::Single), time(sf::Time::Zero), duration(dur), lookupTable(false)
 		{
 		}
 		// Destructor
@@ -296,11 +474,20 @@ namespace oak
 		{
 			time = newTime;
 		}
+		void setLookupTable(bool enabled)
+		{
+			lookupTable = enabled;
+		}
 		// Accessors
 		// Utilities
 		void update(const sf::Time & elapsed)
 		{
 			time += elapsed;
+			if (lookupTable && style != TweenerStyle::Random)
+			{
+				reference = static_cast<float>(start + (finish - start) * EasingTable::get(style, period).at(time.asSeconds(), duration.asSeconds()));
+				return;
+			}
 			switch (style)
 			{
 			case TweenerStyle::Constant:
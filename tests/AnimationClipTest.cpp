@@ -0,0 +1,73 @@
+#include <string>
+#include <vector>
+
+#include "AnimationClip.hpp"
+#include "SML.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	sfext::AnimationClip makeClip(sfext::LoopMode mode)
+	{
+		// Three frames lasting 0.1, 0.2 and 0.3 seconds
+		std::vector<sf::IntRect> rectangles = { sf::IntRect(0, 0, 8, 8), sf::IntRect(8, 0, 8, 8), sf::IntRect(16, 0, 8, 8) };
+		std::vector<sf::Time> durations = { sf::seconds(.1f), sf::seconds(.2f), sf::seconds(.3f) };
+		return sfext::AnimationClip(rectangles, durations, mode);
+	}
+
+	void testNegativeTimes()
+	{
+		// Looping clips wrap negative times the way Animation::currentFrame does; ONCE holds the first frame until it starts
+		sfext::AnimationClip loop = makeClip(sfext::LoopMode::LOOP);
+		CHECK(loop.frameAt(sf::seconds(.05f)) == 0 && loop.frameAt(sf::seconds(.25f)) == 1 && loop.frameAt(sf::seconds(.45f)) == 2);
+		CHECK(loop.frameAt(sf::seconds(-.05f)) == 2 && loop.frameAt(sf::seconds(-.4f)) == 1 && loop.frameAt(sf::seconds(-.55f)) == 0);
+		CHECK(loop.frameAt(sf::seconds(-1.15f)) == loop.frameAt(sf::seconds(.05f)));
+		sfext::AnimationClip pingPong = makeClip(sfext::LoopMode::PINGPONG);
+		CHECK(pingPong.frameAt(sf::seconds(.65f)) == 2 && pingPong.frameAt(sf::seconds(1.15f)) == 0);
+		CHECK(pingPong.frameAt(sf::seconds(-.05f)) == 0 && pingPong.frameAt(sf::seconds(-.65f)) == 2);
+		sfext::AnimationClip once = makeClip(sfext::LoopMode::ONCE);
+		CHECK(once.frameAt(sf::seconds(-5.f)) == 0 && once.frameAt(sf::seconds(5.f)) == 2);
+	}
+
+	void testLoadFromSML()
+	{
+		ash::SML sml;
+		sml.setValue("walk", "rects", "0, 0, 8, 8, 8, 0, 8, 8");
+		sml.setValue("walk", "durations", "0.1, 0.2");
+		sml.setValue("idle", "rects", "0, 8, 8, 8");
+		sml.setValue("idle", "durations", "0.5");
+		sml.setValue("idle", "loop", "once");
+		// Each of these would load as a clip with 0 second frames if read with SML::interpretAsList
+		sml.setValue("typo", "rects", "0, 0, 8, 8");
+		sml.setValue("typo", "durations", "0.l");
+		sml.setValue("zero", "rects", "0, 0, 8, 8");
+		sml.setValue("zero", "durations", "0");
+		sml.setValue("negative", "rects", "0, 0, 8, 8, 8, 0, 8, 8");
+		sml.setValue("negative", "durations", "0.1, -0.1");
+		sml.setValue("missing", "rects", "0, 0, 8, 8");
+		sml.setValue("fraction", "rects", "0, 0, 8.5, 8");
+		sml.setValue("fraction", "durations", "0.1");
+		sml.setValue("word", "rects", "0, 0, eight, 8");
+		sml.setValue("word", "durations", "0.1");
+		sml.setValue("empty", "rects", "0, 0, 8, 8");
+		sml.setValue("empty", "durations", "0.1, , 0.1");
+		sfext::ClipSet clips;
+		std::vector<std::string> errors;
+		CHECK(!clips.loadFromSML(sml, &errors));
+		CHECK(clips.getSize() == 2 && errors.size() == 7);
+		CHECK(clips.hasClip("walk") && clips.getClip("walk")->getFrameCount() == 2);
+		CHECK(clips.getClip("walk")->getDuration(1) == sf::seconds(.2f) && clips.getClip("walk")->getFrame(1) == sf::IntRect(8, 0, 8, 8));
+		CHECK(clips.hasClip("idle") && clips.getClip("idle")->getLoopMode() == sfext::LoopMode::ONCE);
+		for (const char * name : { "typo", "zero", "negative", "missing", "fraction", "word", "empty" })
+		{
+			CHECK(!clips.hasClip(name));
+		}
+	}
+}
+
+int main()
+{
+	testNegativeTimes();
+	testLoadFromSML();
+	return 0;
+}
\ No newline at end of file
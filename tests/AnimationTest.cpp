@@ -0,0 +1,58 @@
+#include <cmath>
+#include <cstdio>
+
+#include "Animation.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void testFrameRects()
+	{
+		// Frames run left to right, then top to bottom, from 'start' with 'offset' pixels between them
+		sf::Texture texture;
+		sfext::Animation animation(sf::Sprite(texture), sf::Vector2f(4.f, 8.f), sf::Vector2f(16.f, 32.f), sf::Vector2f(2.f, 1.f), sf::Vector2u(3, 2), 10.f);
+		CHECK(animation.getFrameRects().size() == 6 && animation.getFrameUVs().size() == 6);
+		for (unsigned int frame = 0; frame < 6; ++frame)
+		{
+			int column = static_cast<int>(frame % 3);
+			int row = static_cast<int>(frame / 3);
+			CHECK(animation.getFrameRects()[frame] == sf::IntRect(4 + column * 18, 8 + row * 33, 16, 32));
+			CHECK(animation.currentTextureRect(frame) == animation.getFrameRects()[frame]);
+		}
+		// Without a texture size the UVs are empty rather than divided by zero
+		CHECK(animation.getFrameUVs()[5] == sf::FloatRect());
+		animation.setRowsAndColumns(2, 2);
+		CHECK(animation.getFrameRects().size() == 4 && animation.getFrameRects()[3] == sf::IntRect(22, 41, 16, 32));
+		// Frame lookup by time, negative times counting back from the last frame
+		CHECK(animation.currentFrame(sf::seconds(.25f)) == 2 && animation.currentFrame(sf::seconds(-.05f)) == 3);
+	}
+
+	void testFrameUVs()
+	{
+		// Texture sizes need an OpenGL context; the check is skipped where none can be created
+		sf::Texture small;
+		sf::Texture large;
+		if (!small.create(64, 128) || !large.create(128, 256))
+		{
+			std::printf("No OpenGL context, frame UV checks skipped\n");
+			return;
+		}
+		sfext::Animation animation(sf::Sprite(small), sf::Vector2f(0.f, 0.f), sf::Vector2f(16.f, 32.f), sf::Vector2f(0.f, 0.f), sf::Vector2u(4, 4));
+		CHECK(animation.getFrameUVs()[5] == sf::FloatRect(.25f, .25f, .25f, .25f));
+		// Pointing the animation at a texture of another size rebuilds the UVs, but not the pixel rectangles
+		animation.setTexture(large);
+		CHECK(animation.getTexture() == &large && animation.getFrameUVs()[5] == sf::FloatRect(.125f, .125f, .125f, .125f));
+		CHECK(animation.getFrameRects()[5] == sf::IntRect(16, 32, 16, 32));
+		// Same for a texture reloaded in place at another size
+		large.create(256, 256);
+		animation.setTexture(large);
+		CHECK(animation.getFrameUVs()[5] == sf::FloatRect(.0625f, .125f, .0625f, .125f));
+	}
+}
+
+int main()
+{
+	testFrameRects();
+	testFrameUVs();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Unlike assert, stays active in release builds, which the benchmarks are meant to run in
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			std::exit(1); \
+		} \
+	} while (false)
+
+namespace test
+{
+	template <class F>
+	double millisecondsPerRun(std::size_t runs, F function)
+	{
+		// Average wall time of 'runs' calls to function()
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (std::size_t run = 0; run < runs; ++run)
+		{
+			function();
+		}
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+#include "ConcurrentSML.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void testQueuedMutations()
+	{
+		ash::ConcurrentSML store;
+		store.setValue("window", "width", "800");
+		store.setValue("window", "height", "600");
+		CHECK(store.getPendingCount() == 2 && !store.hasTag("window", "width"));
+		ash::SMLSnapshot before = store.getSnapshot();
+		store.publish();
+		CHECK(store.getPendingCount() == 0 && store.getValue("window", "width") == "800" && store.getValue("window", "height") == "600");
+		// Snapshots taken earlier never change
+		CHECK(!before->hasTag("window", "width"));
+		store.removeTag("window", "height");
+		store.discardPending();
+		store.publish();
+		CHECK(store.hasTag("window", "height"));
+	}
+
+	void testReader()
+	{
+		// A reader keeps its snapshot between publishes and picks up each publish on its next read
+		ash::ConcurrentSML store;
+		ash::SMLReader reader(store);
+		store.setValue("window", "width", "800");
+		CHECK(!reader.get().hasTag("window", "width"));
+		store.publish();
+		CHECK(reader.getValue("window", "width") == "800");
+		const ash::SML * cached = &reader.get();
+		CHECK(&reader.get() == cached);
+		store.update([](ash::SML & sml)
+		{
+			sml.setValue("window", "width", "1024");
+		});
+		CHECK(reader.getValue("window", "width") == "1024" && store.getVersion() == 2);
+	}
+
+	void benchmarkContention(bool throughReader)
+	{
+		// Eight readers check that both tags of every snapshot come from the same update while one writer publishes as fast as it can
+		const unsigned int readerCount = 8;
+		ash::ConcurrentSML store;
+		store.update([](ash::SML & sml)
+		{
+			sml.setValue("pair", "first", "0");
+			sml.setValue("pair", "second", "0");
+		});
+		std::atomic<bool> running(true);
+		std::atomic<bool> torn(false);
+		std::atomic<unsigned long long> reads(0);
+		std::vector<std::thread> readers;
+		for (unsigned int i = 0; i < readerCount; ++i)
+		{
+			readers.emplace_back([&]
+			{
+				unsigned long long count = 0;
+				ash::SMLReader reader(store);
+				while (running)
+				{
+					ash::SMLSnapshot snapshot;
+					const ash::SML & sml = throughReader ? reader.get() : *(snapshot = store.getSnapshot());
+					if (sml.getValue("pair", "first") != sml.getValue("pair", "second"))
+					{
+						torn = true;
+					}
+					++count;
+				}
+				reads += count;
+			});
+		}
+		unsigned long long writes = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500))
+		{
+			std::string value = std::to_string(++writes);
+			store.update([&value](ash::SML & sml)
+			{
+				sml.setValue("pair", "first", value);
+				sml.setValue("pair", "second", value);
+			});
+		}
+		running = false;
+		for (std::thread & reader : readers)
+		{
+			reader.join();
+		}
+		CHECK(!torn);
+		CHECK(store.getValue("pair", "first") == std::to_string(writes));
+		std::printf("%u readers through %s: %llu reads and %llu published updates in 500 ms\n", readerCount, throughReader ? "SMLReader" : "getSnapshot", static_cast<unsigned long long>(reads), writes);
+	}
+}
+
+int main()
+{
+	testQueuedMutations();
+	testReader();
+	benchmarkContention(false);
+	benchmarkContention(true);
+	return 0;
+}
\ No newline at end of file
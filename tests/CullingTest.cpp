@@ -0,0 +1,94 @@
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Culling.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	bool overlaps(const sf::Vector2f & position, const sf::Vector2f & size, const sf::FloatRect & area)
+	{
+		return position.x + size.x > area.left && position.x < area.left + area.width && position.y + size.y > area.top && position.y < area.top + area.height;
+	}
+
+	std::size_t cullReference(const std::vector<sf::Vector2f> & positions, const sf::Vector2f & size, const sf::FloatRect & area, std::vector<std::uint32_t> & visible)
+	{
+		// One pass with a branch per quad, as batchVisible would be written without cullQuads
+		visible.clear();
+		for (std::size_t i = 0; i < positions.size(); ++i)
+		{
+			if (overlaps(positions[i], size, area))
+			{
+				visible.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+		return visible.size();
+	}
+
+	void testMatchesReference()
+	{
+		// Counts around the block size, so partial blocks and empty input are covered
+		std::mt19937 random(38);
+		std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+		std::uniform_int_distribution<int> size(-64, 64);
+		sf::FloatRect area(-300.f, -200.f, 600.f, 400.f);
+		for (std::size_t count : { 0, 1, 255, 256, 257, 1000, 4099 })
+		{
+			std::vector<sf::Vector2f> positions;
+			std::vector<sf::IntRect> rectangles;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				positions.push_back(sf::Vector2f(position(random), position(random)));
+				rectangles.push_back(sf::IntRect(0, 0, size(random), size(random)));
+			}
+			std::vector<std::uint32_t> visible;
+			std::vector<std::uint32_t> expected;
+			CHECK(sfext::cullQuads(positions, sf::Vector2f(32.f, 48.f), area, visible) == cullReference(positions, sf::Vector2f(32.f, 48.f), area, expected));
+			CHECK(visible == expected);
+			sfext::cullQuads(positions, rectangles, area, visible);
+			expected.clear();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sf::Vector2f quadSize(static_cast<float>(std::abs(rectangles[i].width)), static_cast<float>(std::abs(rectangles[i].height)));
+				if (overlaps(positions[i], quadSize, area))
+				{
+					expected.push_back(static_cast<std::uint32_t>(i));
+				}
+			}
+			CHECK(visible == expected);
+		}
+	}
+
+	void benchmarkMillionQuads()
+	{
+		// About a quarter of the quads in view, so the reference loop's branch is unpredictable
+		std::mt19937 random(1000000);
+		std::uniform_real_distribution<float> position(-2000.f, 2000.f);
+		std::vector<sf::Vector2f> positions;
+		for (std::size_t i = 0; i < 1000000; ++i)
+		{
+			positions.push_back(sf::Vector2f(position(random), position(random)));
+		}
+		sf::FloatRect area(-1000.f, -1000.f, 2000.f, 2000.f);
+		std::vector<std::uint32_t> visible;
+		std::size_t found = 0;
+		double blocked = test::millisecondsPerRun(20, [&]
+		{
+			found = sfext::cullQuads(positions, sf::Vector2f(16.f, 16.f), area, visible);
+		});
+		double reference = test::millisecondsPerRun(20, [&]
+		{
+			cullReference(positions, sf::Vector2f(16.f, 16.f), area, visible);
+		});
+		std::printf("1M quads, %u visible: cullQuads %.2f ms, branching loop %.2f ms\n", static_cast<unsigned int>(found), blocked, reference);
+	}
+}
+
+int main()
+{
+	testMatchesReference();
+	benchmarkMillionQuads();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#include "Tweener.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	const float Start = 2.f;
+	const float Finish = 10.f;
+
+	float allowedError(oak::TweenerStyle style, float fraction)
+	{
+		// As a fraction of the range; Circular curves have an infinite slope where each duration starts and ends, which linear interpolation cannot follow
+		// Elsewhere the tables are within 1e-5 of the curves (see testReport); rounding the time to a phase in floats adds up to about another 1e-5
+		if (style == oak::TweenerStyle::Circular && (fraction < .1f || fraction > .9f))
+		{
+			return .025f;
+		}
+		return 2.5e-5f;
+	}
+
+	void testMatchesAnalytic()
+	{
+		// Tweener and DiscreteTweener, analytic against table, over six durations of non-negative time
+		for (int i = 0; i < static_cast<int>(oak::TweenerStyle::Random); ++i)
+		{
+			for (int j = 0; j <= static_cast<int>(oak::TweenerPeriod::WrapAround); ++j)
+			{
+				oak::TweenerStyle style = static_cast<oak::TweenerStyle>(i);
+				oak::TweenerPeriod period = static_cast<oak::TweenerPeriod>(j);
+				for (float duration : { .25f, 1.5f })
+				{
+					float analyticValue = 0.f;
+					float tableValue = 0.f;
+					oak::Tweener analytic(Start, Finish, sf::seconds(duration));
+					oak::Tweener table(Start, Finish, sf::seconds(duration));
+					oak::DiscreteTweener discreteAnalytic(analyticValue, Start, Finish, sf::seconds(duration));
+					oak::DiscreteTweener discreteTable(tableValue, Start, Finish, sf::seconds(duration));
+					analytic.setStyle(style);
+					table.setStyle(style);
+					discreteAnalytic.setStyle(style);
+					discreteTable.setStyle(style);
+					analytic.setPeriod(period);
+					table.setPeriod(period);
+					discreteAnalytic.setPeriod(period);
+					discreteTable.setPeriod(period);
+					table.setLookupTable(true);
+					discreteTable.setLookupTable(true);
+					CHECK(table.usesLookupTable() && !analytic.usesLookupTable());
+					for (int k = 0; k < 20000; ++k)
+					{
+						float time = (static_cast<float>(k) + .37f) * 6.f * duration / 20000.f;
+						float fraction = std::fmod(time, duration) / duration;
+						if (fraction < 1e-3f || fraction > 1.f - 1e-3f)
+						{
+							// Wrap-around curves jump at every multiple of the duration, where either side is right
+							continue;
+						}
+						analytic.setCurrentTime(sf::seconds(time));
+						table.setCurrentTime(sf::seconds(time));
+						discreteAnalytic.setCurrentTime(sf::seconds(time));
+						discreteTable.setCurrentTime(sf::seconds(time));
+						discreteAnalytic.update(sf::Time::Zero);
+						discreteTable.update(sf::Time::Zero);
+						float limit = allowedError(style, fraction) * (Finish - Start);
+						CHECK(std::fabs(analytic.get() - table.get()) <= limit);
+						CHECK(std::fabs(analyticValue - tableValue) <= limit);
+					}
+				}
+			}
+		}
+	}
+
+	void testReport()
+	{
+		// The figures setLookupTable's documentation quotes: 1e-5 of the range, about 2% at the ends of Circular curves
+		std::vector<oak::EasingReport> report = oak::reportEasingTables();
+		CHECK(report.size() == static_cast<std::size_t>(oak::TweenerStyle::Random) * 3);
+		for (const oak::EasingReport & entry : report)
+		{
+			CHECK(entry.meanError <= entry.maximumError);
+			CHECK(entry.maximumError <= (entry.style == oak::TweenerStyle::Circular ? .025f : 1e-5f));
+			if (entry.style == oak::TweenerStyle::Sinusoidal || entry.style == oak::TweenerStyle::Circular)
+			{
+				std::printf("style %d, period %d: maximum error %.2e, mean %.2e, analytic %.1f ns, table %.1f ns\n", static_cast<int>(entry.style), static_cast<int>(entry.period), entry.maximumError, entry.meanError, entry.analyticNanoseconds, entry.tableNanoseconds);
+			}
+		}
+	}
+
+	void testZeroDuration()
+	{
+		// Single tweens have finished and repeating ones have not started, as the analytic path reports
+		for (oak::TweenerPeriod period : { oak::TweenerPeriod::Single, oak::TweenerPeriod::WrapAround })
+		{
+			const oak::EasingTable & table = oak::EasingTable::get(oak::TweenerStyle::Linear, period);
+			CHECK(table.getResolution() == 512);
+			CHECK(table.at(1.f, 0.f) == (period == oak::TweenerPeriod::Single ? 1.f : 0.f));
+		}
+	}
+}
+
+int main()
+{
+	testMatchesAnalytic();
+	testReport();
+	testZeroDuration();
+	return 0;
+}
\ No newline at end of file
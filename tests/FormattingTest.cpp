@@ -0,0 +1,69 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "FormattingFunctions.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void testFormatInteger()
+	{
+		char buffer[ash::NUMBER_BUFFER_SIZE];
+		std::mt19937_64 random(46);
+		std::vector<long long> values = { 0, 1, -1, 9, 10, -10, 123456789, std::numeric_limits<long long>::max(), std::numeric_limits<long long>::min() };
+		for (int i = 0; i < 10000; ++i)
+		{
+			values.push_back(static_cast<long long>(random()) >> (i % 63));
+		}
+		for (long long value : values)
+		{
+			std::size_t length = ash::formatInteger(buffer, value);
+			CHECK(std::to_string(value) == buffer && std::strlen(buffer) == length);
+		}
+	}
+
+	void testFormatDecimal()
+	{
+		// Matches printf except, now and then, by one unit in the last digit (ties and double rounding)
+		char buffer[ash::NUMBER_BUFFER_SIZE];
+		char reference[64];
+		std::mt19937 random(47);
+		std::uniform_real_distribution<double> magnitude(-1e6, 1e6);
+		std::vector<double> values = { 0.0, -0.0, 1.5, -2.25, 3.14159265, 1e-7, -1e-7, 123456.789, 0.0000005, 0.9999996, 1e12 };
+		for (int i = 0; i < 10000; ++i)
+		{
+			values.push_back(magnitude(random));
+		}
+		for (double value : values)
+		{
+			for (unsigned int precision = 0; precision <= 9; ++precision)
+			{
+				std::size_t length = ash::formatDecimal(buffer, value, precision);
+				std::snprintf(reference, sizeof(reference), "%.*f", static_cast<int>(precision), value);
+				CHECK(std::strlen(buffer) == length && length < ash::NUMBER_BUFFER_SIZE);
+				if (std::strcmp(buffer, reference) != 0)
+				{
+					CHECK(std::strlen(reference) == length && std::fabs(std::atof(buffer) - std::atof(reference)) <= 1.5 / std::pow(10.0, precision));
+				}
+			}
+		}
+		// Values the fixed point path cannot hold still fit the buffer
+		for (double value : { 1e300, -1e300, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() })
+		{
+			CHECK(ash::formatDecimal(buffer, value, 9) < ash::NUMBER_BUFFER_SIZE);
+		}
+	}
+}
+
+int main()
+{
+	testFormatInteger();
+	testFormatDecimal();
+	return 0;
+}
\ No newline at end of file
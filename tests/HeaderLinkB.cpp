@@ -0,0 +1,26 @@
+// Included from two translation units: any non-inline definition in these headers fails to link
+#include "Animation.hpp"
+#include "AnimationClip.hpp"
+#include "AnimationHandler.hpp"
+#include "AnimationPool.hpp"
+#include "Culling.hpp"
+#include "FontHandler.hpp"
+#include "FormattingFunctions.hpp"
+#include "HandleTable.hpp"
+#include "QuadKernel.hpp"
+#include "RenderQueue.hpp"
+#include "SpriteBatch.hpp"
+#include "SpriteHandler.hpp"
+#include "StaticSpriteLayer.hpp"
+#include "TextBatch.hpp"
+#include "TextHandler.hpp"
+#include "TextureAtlas.hpp"
+#include "TextureCache.hpp"
+#include "TextureHandler.hpp"
+#include "TextureLoader.hpp"
+#include "ThreadPool.hpp"
+
+int main()
+{
+	return 0;
+}
\ No newline at end of file
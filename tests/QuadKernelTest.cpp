@@ -0,0 +1,192 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "QuadKernel.hpp"
+#include "SpriteBatch.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	sfext::QuadStreams makeQuads(std::size_t count, bool rotated, bool scaled, std::mt19937 & random)
+	{
+		std::uniform_real_distribution<float> position(-5000.f, 5000.f);
+		std::uniform_int_distribution<int> size(-64, 64);
+		std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+		std::uniform_real_distribution<float> factor(.25f, 4.f);
+		sfext::QuadStreams quads;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			sf::IntRect rectangle(size(random) + 64, size(random) + 64, size(random), size(random));
+			if (rotated || scaled)
+			{
+				quads.append(sf::Vector2f(position(random), position(random)), rectangle, rotated ? angle(random) : 0.f, scaled ? sf::Vector2f(factor(random), factor(random)) : sf::Vector2f(1.f, 1.f));
+			}
+			else
+			{
+				quads.append(sf::Vector2f(position(random), position(random)), rectangle);
+			}
+		}
+		if (!rotated)
+		{
+			quads.rotation.clear();
+		}
+		if (!scaled)
+		{
+			quads.scaleX.clear();
+			quads.scaleY.clear();
+		}
+		return quads;
+	}
+
+	bool near(const sf::Vector2f & lhs, const sf::Vector2f & rhs, float tolerance)
+	{
+		return std::fabs(lhs.x - rhs.x) <= tolerance && std::fabs(lhs.y - rhs.y) <= tolerance;
+	}
+
+	bool sameVertices(const std::vector<sf::Vertex> & lhs, const std::vector<sf::Vertex> & rhs, float tolerance = 0.f)
+	{
+		// Texture coordinates are always exact; positions of rotated quads differ by the polynomial sine and cosine's error
+		for (std::size_t i = 0; i < lhs.size(); ++i)
+		{
+			if (!near(lhs[i].position, rhs[i].position, tolerance) || lhs[i].texCoords != rhs[i].texCoords)
+			{
+				std::fprintf(stderr, "vertex %u differs\n", static_cast<unsigned int>(i));
+				return false;
+			}
+		}
+		return lhs.size() == rhs.size();
+	}
+
+	void testSimdMatchesScalar()
+	{
+		std::mt19937 random(35);
+		for (std::size_t count : { 0, 1, 3, 4, 5, 8, 13, 1021 })
+		{
+			for (int variant = 0; variant < 4; ++variant)
+			{
+				// Positions reach 5000 + 4 * 64 * sqrt(2), where a float's spacing is about 5e-4
+				bool rotated = (variant & 1) != 0;
+				float tolerance = rotated ? 2e-3f : 0.f;
+				sfext::QuadStreams quads = makeQuads(count, rotated, (variant & 2) != 0, random);
+				std::vector<sf::Vertex> simd(count * 4);
+				std::vector<sf::Vertex> scalar(count * 4);
+				if (count)
+				{
+					sfext::expandQuads(quads, &simd[0]);
+					sfext::expandQuadsScalar(quads, &scalar[0], 0, count);
+				}
+				CHECK(sameVertices(simd, scalar, tolerance));
+				// Ranges that do not start on a multiple of four
+				if (count > 2)
+				{
+					std::vector<sf::Vertex> partial(count * 4);
+					sfext::expandQuads(quads, &partial[0], 1, count);
+					sfext::expandQuadsScalar(quads, &partial[0], 0, 1);
+					CHECK(sameVertices(partial, scalar, tolerance));
+				}
+			}
+		}
+	}
+
+	void testSinCos()
+	{
+#ifdef SFEXT_QUADKERNEL_SSE
+		// Within the documented range the polynomial stays within a few float spacings of the library functions
+		std::mt19937 random(350);
+		std::uniform_real_distribution<float> small(-7.f, 7.f);
+		std::uniform_real_distribution<float> large(-8192.f, 8192.f);
+		float worstSmall = 0.f;
+		float worstLarge = 0.f;
+		for (int i = 0; i < 100000; ++i)
+		{
+			for (int range = 0; range < 2; ++range)
+			{
+				alignas(16) float radians[4];
+				alignas(16) float sines[4];
+				alignas(16) float cosines[4];
+				for (float & angle : radians)
+				{
+					angle = range ? large(random) : small(random);
+				}
+				__m128 sine;
+				__m128 cosine;
+				sfext::sinCos4(_mm_load_ps(radians), sine, cosine);
+				_mm_store_ps(sines, sine);
+				_mm_store_ps(cosines, cosine);
+				for (int j = 0; j < 4; ++j)
+				{
+					float error = std::max(std::fabs(sines[j] - std::sin(radians[j])), std::fabs(cosines[j] - std::cos(radians[j])));
+					float & worst = range ? worstLarge : worstSmall;
+					worst = std::max(worst, error);
+				}
+			}
+		}
+		std::printf("sinCos4 worst error: %.2e below 7 radians, %.2e below 8192\n", worstSmall, worstLarge);
+		CHECK(worstSmall < 2e-7f && worstLarge < 1e-6f);
+		// Angles beyond the range go through the library functions, so they expand exactly as in the scalar path
+		sfext::QuadStreams quads;
+		for (float angle : { 1e5f, -3e6f, .5f, 1e9f })
+		{
+			quads.append(sf::Vector2f(1.f, 2.f), sf::IntRect(0, 0, 32, 16), angle, sf::Vector2f(1.f, 1.f));
+		}
+		std::vector<sf::Vertex> simd(16);
+		std::vector<sf::Vertex> scalar(16);
+		sfext::expandQuads(quads, &simd[0]);
+		sfext::expandQuadsScalar(quads, &scalar[0], 0, 4);
+		CHECK(sameVertices(simd, scalar));
+#endif
+	}
+
+	void testMatchesSpriteBatch()
+	{
+		// Axis-aligned streams give the same quads as SpriteBatch::writeQuad, flipped rectangles included
+		std::mt19937 random(36);
+		sfext::QuadStreams quads = makeQuads(257, false, false, random);
+		std::vector<sf::Vertex> expanded(quads.size() * 4);
+		sfext::expandQuads(quads, &expanded[0]);
+		for (std::size_t i = 0; i < quads.size(); ++i)
+		{
+			sf::IntRect rectangle(static_cast<int>(quads.u[i]), static_cast<int>(quads.v[i]), static_cast<int>(quads.uWidth[i]), static_cast<int>(quads.vHeight[i]));
+			sf::Vertex written[4];
+			sfext::SpriteBatch::writeQuad(written, sf::Vector2f(quads.x[i], quads.y[i]), rectangle);
+			for (std::size_t corner = 0; corner < 4; ++corner)
+			{
+				CHECK(written[corner].position == expanded[i * 4 + corner].position);
+				CHECK(written[corner].texCoords == expanded[i * 4 + corner].texCoords);
+			}
+		}
+	}
+
+	void benchmarkMillionQuads()
+	{
+		std::mt19937 random(1000000);
+		const std::size_t count = 1000000;
+		for (int variant = 0; variant < 2; ++variant)
+		{
+			sfext::QuadStreams quads = makeQuads(count, variant != 0, variant != 0, random);
+			std::vector<sf::Vertex> vertices(count * 4);
+			double simd = test::millisecondsPerRun(10, [&]
+			{
+				sfext::expandQuads(quads, &vertices[0]);
+			});
+			double scalar = test::millisecondsPerRun(10, [&]
+			{
+				sfext::expandQuadsScalar(quads, &vertices[0], 0, count);
+			});
+			// Axis-aligned streams take the scalar loop in both, so only the rotated timings compare the two paths
+			std::printf("1M %s quads: expandQuads %.2f ms, expandQuadsScalar %.2f ms (SIMD %s)\n", variant ? "rotated and scaled" : "axis-aligned", simd, scalar, sfext::hasQuadKernelSimd() && variant ? "on" : "off");
+		}
+	}
+}
+
+int main()
+{
+	testSimdMatchesScalar();
+	testSinCos();
+	testMatchesSpriteBatch();
+	benchmarkMillionQuads();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <list>
+#include <string>
+#include <vector>
+
+#include "SMLSchema.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	struct Settings
+	{
+		int            width;
+		unsigned int   lives;
+		float          speed;
+		sf::Vector2i   spawn;
+		sf::Color      tint;
+		sf::String     title;
+		std::list<int> levels;
+	};
+
+	ash::SMLSchema<Settings> makeSchema()
+	{
+		ash::SMLSchema<Settings> schema;
+		schema.bindNumber("window", "width", &Settings::width, 800, true);
+		schema.bindNumber("player", "lives", &Settings::lives, 3u);
+		schema.bindNumber("player", "speed", &Settings::speed, 1.f);
+		schema.bindVector2("player", "spawn", &Settings::spawn);
+		schema.bindColor("player", "tint", &Settings::tint);
+		schema.bindString("window", "title", &Settings::title, sf::String("Untitled"));
+		schema.bindList("game", "levels", &Settings::levels);
+		return schema;
+	}
+
+	void testValid()
+	{
+		ash::SML sml;
+		sml.setValue("window", "width", "1280");
+		sml.setValue("player", "speed", " 2.5 ");
+		sml.setValue("player", "spawn", "-4, 16");
+		sml.setValue("player", "tint", "255, 128, 0");
+		sml.setValue("game", "levels", "1, 2, 3");
+		Settings settings;
+		std::vector<std::string> errors;
+		CHECK(makeSchema().load(sml, settings, &errors) && errors.empty());
+		CHECK(settings.width == 1280 && settings.speed == 2.5f && settings.spawn == sf::Vector2i(-4, 16));
+		CHECK(settings.tint == sf::Color(255, 128, 0, 255) && settings.levels == std::list<int>({ 1, 2, 3 }));
+		// Missing optional fields take their defaults
+		CHECK(settings.lives == 3u && settings.title == sf::String("Untitled"));
+	}
+
+	void testRejected()
+	{
+		// Each of these would load as a truncated or wrapped value through SML::interpretAs
+		const char * invalid[][3] = {
+			{ "window", "width", "12.5" },
+			{ "window", "width", "1e10" },
+			{ "window", "width", "wide" },
+			{ "player", "lives", "-1" },
+			{ "player", "speed", "1e40" },
+			{ "player", "spawn", "1, 2, 3" },
+			{ "player", "spawn", "1.5, 2" },
+			{ "player", "tint", "256, 0, 0" },
+			{ "game", "levels", "1, two, 3" },
+		};
+		for (const auto & value : invalid)
+		{
+			ash::SML sml;
+			sml.setValue("window", "width", "640");
+			sml.setValue(value[0], value[1], value[2]);
+			Settings settings;
+			std::vector<std::string> errors;
+			CHECK(!makeSchema().load(sml, settings, &errors) && errors.size() == 1);
+			CHECK(errors[0].find(std::string(value[0]) + "." + value[1]) == 0);
+		}
+		// A rejected value falls back to its default
+		ash::SML sml;
+		sml.setValue("window", "width", "640.5");
+		Settings settings;
+		CHECK(!makeSchema().load(sml, settings) && settings.width == 800);
+		// Required fields are reported when missing, and still get their default
+		ash::SML empty;
+		std::vector<std::string> errors;
+		CHECK(!makeSchema().load(empty, settings, &errors) && errors.size() == 1 && settings.width == 800);
+	}
+
+	void testStrict()
+	{
+		// Unknown tags in a bound variable are only errors in strict mode; unbound variables are never checked
+		ash::SML sml;
+		sml.setValue("window", "width", "640");
+		sml.setValue("player", "sped", "2");
+		sml.setValue("audio", "volume", "10");
+		ash::SMLSchema<Settings> schema = makeSchema();
+		Settings settings;
+		std::vector<std::string> errors;
+		CHECK(!schema.isStrict() && schema.load(sml, settings, &errors) && errors.empty());
+		schema.setStrict(true);
+		CHECK(schema.isStrict() && !schema.load(sml, settings, &errors));
+		CHECK(errors.size() == 1 && errors[0] == "player.sped is not part of the schema");
+		CHECK(settings.width == 640 && schema.getFieldCount() == 7);
+	}
+}
+
+int main()
+{
+	testValid();
+	testRejected();
+	testStrict();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include <random>
+#include <vector>
+#include <cstdio>
+
+#include "SpriteBatch.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void makeScene(std::size_t count, std::mt19937 & random, std::vector<sf::Vector2f> & positions, std::vector<sf::IntRect> & rectangles)
+	{
+		std::uniform_real_distribution<float> position(-5000.f, 5000.f);
+		std::uniform_int_distribution<int> size(-64, 64);
+		positions.clear();
+		rectangles.clear();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			positions.push_back(sf::Vector2f(position(random), position(random)));
+			rectangles.push_back(sf::IntRect(size(random) + 64, size(random) + 64, size(random), size(random)));
+		}
+	}
+
+	bool sameVertices(const std::vector<sf::Vertex> & lhs, const std::vector<sf::Vertex> & rhs)
+	{
+		for (std::size_t i = 0; i < lhs.size(); ++i)
+		{
+			if (lhs[i].position != rhs[i].position || lhs[i].texCoords != rhs[i].texCoords || lhs[i].color != rhs[i].color)
+			{
+				std::fprintf(stderr, "vertex %u differs\n", static_cast<unsigned int>(i));
+				return false;
+			}
+		}
+		return lhs.size() == rhs.size();
+	}
+
+	void testPartialUpdates()
+	{
+		// Updating some quads in place gives the same vertices as rebuilding the batch from the updated inputs
+		std::mt19937 random(33);
+		std::vector<sf::Vector2f> positions;
+		std::vector<sf::IntRect> rectangles;
+		makeScene(1000, random, positions, rectangles);
+		sf::Texture texture;
+		sfext::SpriteBatch batch(texture, positions, rectangles);
+		CHECK(batch.getQuadCount() == positions.size() && batch.getTexture() == &texture);
+		for (std::size_t i = 0; i < positions.size(); i += 7)
+		{
+			positions[i] += sf::Vector2f(3.5f, -2.f);
+			batch.setPosition(i, positions[i]);
+		}
+		for (std::size_t i = 0; i < positions.size(); i += 11)
+		{
+			rectangles[i] = sf::IntRect(1, 2, -30, 40);
+			batch.setTextureRect(i, rectangles[i]);
+		}
+		positions[500] = sf::Vector2f(10.f, 20.f);
+		rectangles[500] = sf::IntRect(0, 0, 8, 8);
+		batch.setQuad(500, positions[500], rectangles[500]);
+		sfext::SpriteBatch rebuilt(texture, positions, rectangles);
+		CHECK(sameVertices(batch.getVertices(), rebuilt.getVertices()));
+		CHECK(batch.getPosition(500) == sf::Vector2f(10.f, 20.f));
+		// Colours only touch the quad they are set on
+		batch.setColor(3, sf::Color::Red);
+		CHECK(batch.getVertices()[12].color == sf::Color::Red && batch.getVertices()[15].color == sf::Color::Red);
+		CHECK(batch.getVertices()[11].color == sf::Color::White && batch.getVertices()[16].color == sf::Color::White);
+		// Appended quads get the next index; clear keeps nothing
+		CHECK(batch.append(sf::Vector2f(), sf::IntRect(0, 0, 4, 4)) == positions.size());
+		CHECK(batch.getQuadCount() == positions.size() + 1);
+		batch.clear();
+		CHECK(batch.getQuadCount() == 0);
+	}
+
+	void benchmarkStaticQuads()
+	{
+		// Vertex generation only; the draw itself costs the same for all three
+		std::mt19937 random(100000);
+		const std::size_t count = 100000;
+		std::vector<sf::Vector2f> positions;
+		std::vector<sf::IntRect> rectangles;
+		makeScene(count, random, positions, rectangles);
+		sf::Texture texture;
+		double appended = test::millisecondsPerRun(20, [&]
+		{
+			// What SpriteHandler::batch did every frame before the retained batch: a new array, appending four vertices per quad
+			sf::VertexArray vertices(sf::Quads);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sf::Vertex quad[4];
+				sfext::SpriteBatch::writeQuad(quad, positions[i], rectangles[i]);
+				for (std::size_t corner = 0; corner < 4; ++corner)
+				{
+					vertices.append(quad[corner]);
+				}
+			}
+			CHECK(vertices.getVertexCount() == count * 4);
+		});
+		sfext::SpriteBatch batch(texture, positions, rectangles);
+		double rebuilt = test::millisecondsPerRun(20, [&]
+		{
+			batch.build(positions, rectangles);
+		});
+		// A static scene where 1% of the quads change each frame
+		std::size_t frame = 0;
+		double retained = test::millisecondsPerRun(20, [&]
+		{
+			for (std::size_t i = frame++ % 100; i < count; i += 100)
+			{
+				batch.setPosition(i, positions[i]);
+			}
+		});
+		std::printf("100k static quads per frame: appended %.3f ms, rebuilt in place %.3f ms, retained with 1%% updated %.3f ms\n", appended, rebuilt, retained);
+	}
+}
+
+int main()
+{
+	testPartialUpdates();
+	benchmarkStaticQuads();
+	return 0;
+}
\ No newline at end of file
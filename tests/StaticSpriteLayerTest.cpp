@@ -0,0 +1,97 @@
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "StaticSpriteLayer.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	bool overlaps(const sf::Vector2f & position, const sf::IntRect & rectangle, const sf::FloatRect & area)
+	{
+		float width = static_cast<float>(std::abs(rectangle.width));
+		float height = static_cast<float>(std::abs(rectangle.height));
+		return position.x + width > area.left && position.x < area.left + area.width && position.y + height > area.top && position.y < area.top + area.height;
+	}
+
+	void checkQueries(const sfext::StaticSpriteLayer & layer, const std::vector<sf::Vector2f> & positions, const std::vector<sf::IntRect> & rectangles, std::mt19937 & random, float extent)
+	{
+		// Every quad overlapping the area is found exactly once; extra quads from the same cells are allowed
+		std::uniform_real_distribution<float> corner(-extent * .1f, extent * 1.1f);
+		std::uniform_real_distribution<float> size(1.f, extent * .2f);
+		std::vector<std::uint32_t> found;
+		for (int query = 0; query < 200; ++query)
+		{
+			sf::FloatRect area(corner(random), corner(random), size(random), size(random));
+			found.clear();
+			CHECK(layer.query(area, found) == found.size());
+			std::sort(found.begin(), found.end());
+			CHECK(std::adjacent_find(found.begin(), found.end()) == found.end());
+			for (std::size_t i = 0; i < positions.size(); ++i)
+			{
+				if (overlaps(positions[i], rectangles[i], area))
+				{
+					CHECK(std::binary_search(found.begin(), found.end(), static_cast<std::uint32_t>(i)));
+				}
+			}
+		}
+	}
+
+	void testDenseLayer()
+	{
+		std::mt19937 random(39);
+		std::uniform_real_distribution<float> position(0.f, 20000.f);
+		std::uniform_int_distribution<int> size(-96, 96);
+		std::vector<sf::Vector2f> positions;
+		std::vector<sf::IntRect> rectangles;
+		for (int i = 0; i < 20000; ++i)
+		{
+			positions.push_back(sf::Vector2f(position(random), position(random)));
+			rectangles.push_back(sf::IntRect(128, 128, size(random), size(random)));
+		}
+		sf::Texture texture;
+		sfext::StaticSpriteLayer layer(texture, positions, rectangles, sf::Vector2f(256.f, 256.f));
+		CHECK(layer.getQuadCount() == positions.size());
+		CHECK(layer.getCellSize() == sf::Vector2f(256.f, 256.f));
+		checkQueries(layer, positions, rectangles, random, 20000.f);
+		// An area away from every quad finds nothing
+		std::vector<std::uint32_t> found;
+		CHECK(layer.query(sf::FloatRect(-5000.f, -5000.f, 100.f, 100.f), found) == 0);
+	}
+
+	void testSparseLayer()
+	{
+		// A few quads spread far apart must not allocate one cell per 16 units of the whole area
+		std::mt19937 random(40);
+		std::vector<sf::Vector2f> positions = { sf::Vector2f(0.f, 0.f), sf::Vector2f(1e7f, 1e7f), sf::Vector2f(5e6f, 0.f), sf::Vector2f(1e8f, 10.f) };
+		std::vector<sf::IntRect> rectangles(positions.size(), sf::IntRect(0, 0, 32, 32));
+		sf::Texture texture;
+		sfext::StaticSpriteLayer layer(texture, positions, rectangles, sf::Vector2f(16.f, 16.f));
+		CHECK(static_cast<double>(layer.getGridSize().x) * layer.getGridSize().y <= 4096.0);
+		for (std::size_t i = 0; i < positions.size(); ++i)
+		{
+			std::vector<std::uint32_t> found;
+			layer.query(sf::FloatRect(positions[i].x + 1.f, positions[i].y + 1.f, 2.f, 2.f), found);
+			CHECK(std::find(found.begin(), found.end(), static_cast<std::uint32_t>(i)) != found.end());
+		}
+		checkQueries(layer, positions, rectangles, random, 1e8f);
+	}
+
+	void testEmptyLayer()
+	{
+		sfext::StaticSpriteLayer layer;
+		layer.build(std::vector<sf::Vector2f>(), sf::IntRect(0, 0, 8, 8));
+		std::vector<std::uint32_t> found;
+		CHECK(layer.getQuadCount() == 0 && layer.query(sf::FloatRect(0.f, 0.f, 100.f, 100.f), found) == 0);
+	}
+}
+
+int main()
+{
+	testDenseLayer();
+	testSparseLayer();
+	testEmptyLayer();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <random>
+#include <vector>
+#include <cstdio>
+
+#include "TextureAtlas.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	bool overlap(const sf::IntRect & lhs, const sf::IntRect & rhs)
+	{
+		return lhs.left < rhs.left + rhs.width && rhs.left < lhs.left + lhs.width && lhs.top < rhs.top + rhs.height && rhs.top < lhs.top + lhs.height;
+	}
+
+	void testNoOverlap()
+	{
+		// Random sizes until the page is full; with padding, each rectangle grown by the padding must not touch another
+		std::mt19937 random(28);
+		std::uniform_int_distribution<unsigned int> size(1, 96);
+		for (unsigned int padding : { 0u, 1u, 3u })
+		{
+			sfext::SkylinePacker packer(sf::Vector2u(512, 384), padding);
+			std::vector<sf::IntRect> placed;
+			unsigned long area = 0;
+			for (int attempt = 0; attempt < 2000; ++attempt)
+			{
+				sf::Vector2u rectangleSize(size(random), size(random));
+				sf::IntRect result;
+				if (packer.insert(rectangleSize, result))
+				{
+					CHECK(result.width == static_cast<int>(rectangleSize.x) && result.height == static_cast<int>(rectangleSize.y));
+					CHECK(result.left >= 0 && result.top >= 0);
+					CHECK(result.left + result.width + static_cast<int>(padding) <= 512 && result.top + result.height + static_cast<int>(padding) <= 384);
+					sf::IntRect padded(result.left, result.top, result.width + static_cast<int>(padding), result.height + static_cast<int>(padding));
+					for (const sf::IntRect & other : placed)
+					{
+						CHECK(!overlap(padded, other));
+					}
+					placed.push_back(padded);
+					area += static_cast<unsigned long>(rectangleSize.x) * rectangleSize.y;
+				}
+			}
+			CHECK(placed.size() > 20 && packer.getUsedArea() == area);
+			std::printf("padding %u: %u rectangles, occupancy %.3f\n", padding, static_cast<unsigned int>(placed.size()), packer.getOccupancy());
+		}
+	}
+
+	void testFullPage()
+	{
+		// Sixteen 64x64 tiles fill a 256x256 page exactly; nothing fits after that, however small
+		sfext::SkylinePacker packer(sf::Vector2u(256, 256));
+		sf::IntRect result;
+		for (int tile = 0; tile < 16; ++tile)
+		{
+			CHECK(packer.insert(sf::Vector2u(64, 64), result));
+		}
+		CHECK(packer.getOccupancy() == 1.f);
+		CHECK(!packer.insert(sf::Vector2u(1, 1), result));
+		// Rejected rectangles leave the packer as it was
+		CHECK(packer.getUsedArea() == 256ul * 256ul);
+		packer.reset(sf::Vector2u(256, 256));
+		CHECK(!packer.insert(sf::Vector2u(257, 1), result) && !packer.insert(sf::Vector2u(1, 257), result));
+		CHECK(packer.getUsedArea() == 0 && packer.insert(sf::Vector2u(256, 256), result) && result == sf::IntRect(0, 0, 256, 256));
+	}
+
+	void testEfficiency()
+	{
+		// Four 64x64 images fill the first 128x128 page; a 32x32 one opens a second, so (4 * 4096 + 1024) / (2 * 16384)
+		sfext::TextureAtlas atlas(sf::Vector2u(128, 128), 0);
+		sf::Image tile;
+		tile.create(64, 64);
+		sf::Image small;
+		small.create(32, 32);
+		sf::Image oversized;
+		oversized.create(129, 8);
+		for (const char * alias : { "a", "b", "c", "d" })
+		{
+			CHECK(atlas.addImage(tile, alias));
+		}
+		CHECK(atlas.addImage(small, "e"));
+		CHECK(!atlas.addImage(oversized, "f"));
+		CHECK(atlas.getEfficiency() == 0.f);
+		CHECK(atlas.pack());
+		CHECK(atlas.getPageCount() == 2 && atlas.getRegion("e").page == 1);
+		CHECK(atlas.getEfficiency() == .53125f);
+		for (const char * alias : { "a", "b", "c", "d" })
+		{
+			CHECK(atlas.getRegion(alias).page == 0);
+		}
+	}
+}
+
+int main()
+{
+	testNoOverlap();
+	testFullPage();
+	testEfficiency();
+	return 0;
+}
\ No newline at end of file
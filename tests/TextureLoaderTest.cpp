@@ -0,0 +1,136 @@
+#include <string>
+#include <vector>
+#include <future>
+#include <stdexcept>
+
+#include "TextureLoader.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	struct Upload
+	{
+		std::string alias;
+		sf::IntRect area;
+		bool        applyFlags;
+		bool        smooth;
+	};
+
+	void testBudget()
+	{
+		// A zero budget still uploads one image per call; an unlimited one drains the queue
+		sfext::TextureLoader loader(2);
+		std::vector<std::shared_future<bool>> results;
+		for (const char * alias : { "a", "b", "c", "d" })
+		{
+			results.push_back(loader.queue("file.png", alias, sf::IntRect(1, 2, 3, 4)));
+		}
+		results.push_back(loader.queue("file.png", "e", true, false));
+		std::shared_future<bool> missing = loader.queue("missing", "f");
+		loader.waitForDecodes();
+		CHECK(loader.getDecodingCount() == 0 && loader.getDecodedCount() == 5);
+		// Failed decodes never reach pumpUploads
+		CHECK(missing.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !missing.get());
+		std::vector<Upload> uploads;
+		auto upload = [&uploads](const sf::String & alias, const sf::Image & image, const sf::IntRect & area, bool applyFlags, bool smooth, bool)
+		{
+			Upload record = { alias.toAnsiString(), area, applyFlags, smooth };
+			uploads.push_back(record);
+			return alias != "b" && image.getSize() == sf::Vector2u(64, 64);
+		};
+		CHECK(loader.pumpUploads(sf::Time::Zero, upload) == 1 && loader.getDecodedCount() == 4);
+		CHECK(loader.pumpUploads(sf::Time::Zero, upload) == 1 && loader.getDecodedCount() == 3);
+		CHECK(loader.pumpUploads(sf::seconds(60.f), upload) == 3 && loader.getDecodedCount() == 0);
+		CHECK(loader.pumpUploads(sf::seconds(60.f), upload) == 0);
+		CHECK(uploads.size() == 5);
+		std::size_t flagged = 0;
+		for (const Upload & record : uploads)
+		{
+			if (record.applyFlags)
+			{
+				CHECK(record.alias == "e" && record.smooth);
+				++flagged;
+			}
+			else
+			{
+				CHECK(record.area == sf::IntRect(1, 2, 3, 4));
+			}
+		}
+		CHECK(flagged == 1);
+		// The callback's result is what the future reports
+		CHECK(results[0].get() && !results[1].get() && results[2].get() && results[3].get() && results[4].get());
+	}
+
+	void testTextureHandler()
+	{
+		sfext::TextureLoader loader(1);
+		sfext::TextureHandler textures;
+		std::shared_future<bool> plain = loader.queue("file.png", "plain");
+		std::shared_future<bool> smooth = loader.queue("file.png", "smooth", true, true);
+		loader.waitForDecodes();
+		CHECK(loader.pumpUploads(textures, sf::seconds(60.f)) == 2);
+		CHECK(plain.get() && smooth.get());
+		CHECK(textures.hasTexture("plain") && textures.hasTexture("smooth"));
+		CHECK(!textures.getTexture("plain").isSmooth() && textures.getTexture("smooth").isSmooth() && textures.getTexture("smooth").isRepeated());
+	}
+
+	void testThrowingUpload()
+	{
+		// The exception reaches both the caller and the request's future; later requests stay queued
+		sfext::TextureLoader loader(1);
+		std::shared_future<bool> first = loader.queue("file.png", "first");
+		loader.waitForDecodes();
+		std::shared_future<bool> second = loader.queue("file.png", "second");
+		loader.waitForDecodes();
+		bool thrown = false;
+		try
+		{
+			loader.pumpUploads(sf::seconds(60.f), [](const sf::String &, const sf::Image &, const sf::IntRect &, bool, bool, bool) -> bool
+			{
+				throw std::runtime_error("upload failed");
+			});
+		}
+		catch (const std::runtime_error &)
+		{
+			thrown = true;
+		}
+		CHECK(thrown && loader.getDecodedCount() == 1);
+		thrown = false;
+		try
+		{
+			first.get();
+		}
+		catch (const std::runtime_error &)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+		CHECK(second.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+	}
+
+	void testDestroyedWithPending()
+	{
+		// Decoded but never uploaded, or not decoded yet: every future still becomes ready, and false, instead of throwing broken_promise
+		std::vector<std::shared_future<bool>> results;
+		{
+			sfext::TextureLoader loader(1);
+			for (int i = 0; i < 100; ++i)
+			{
+				results.push_back(loader.queue("file.png", "alias" + std::to_string(i)));
+			}
+		}
+		for (std::shared_future<bool> & result : results)
+		{
+			CHECK(result.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !result.get());
+		}
+	}
+}
+
+int main()
+{
+	testBudget();
+	testTextureHandler();
+	testThrowingUpload();
+	testDestroyedWithPending();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <future>
+#include <vector>
+#include <cstdio>
+#include <stdexcept>
+
+#include "ThreadPool.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void testCoversEveryIndex()
+	{
+		oak::ThreadPool pool(3);
+		for (std::size_t count : { 0, 1, 2, 7, 100, 1001, 65536 })
+		{
+			for (std::size_t minimumRange : { 1, 3, 64, 100000 })
+			{
+				std::vector<std::atomic<int>> hits(count);
+				for (std::atomic<int> & hit : hits)
+				{
+					hit = 0;
+				}
+				pool.parallelFor(count, minimumRange, [&](std::size_t first, std::size_t last)
+				{
+					CHECK(first < last && last <= count);
+					for (std::size_t i = first; i < last; ++i)
+					{
+						++hits[i];
+					}
+				});
+				for (const std::atomic<int> & hit : hits)
+				{
+					CHECK(hit == 1);
+				}
+			}
+		}
+	}
+
+	void testRethrows()
+	{
+		// Every range still runs; the first exception reaches the caller once they are all done
+		oak::ThreadPool pool(2);
+		std::atomic<std::size_t> covered(0);
+		bool thrown = false;
+		try
+		{
+			pool.parallelFor(3000, 1000, [&](std::size_t first, std::size_t last)
+			{
+				covered += last - first;
+				if (first == 1000)
+				{
+					throw std::runtime_error("range failed");
+				}
+			});
+		}
+		catch (const std::runtime_error &)
+		{
+			thrown = true;
+		}
+		CHECK(thrown && covered == 3000);
+	}
+
+	void testBusyPool()
+	{
+		// With every worker stuck on a long task, the caller runs all the ranges itself instead of waiting behind it
+		oak::ThreadPool pool(2);
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		std::vector<std::future<void>> blockers;
+		for (int worker = 0; worker < 2; ++worker)
+		{
+			blockers.push_back(pool.enqueue([released]
+			{
+				released.wait();
+			}));
+		}
+		std::vector<int> values(10000, 0);
+		pool.parallelFor(values.size(), 100, [&](std::size_t first, std::size_t last)
+		{
+			for (std::size_t i = first; i < last; ++i)
+			{
+				values[i] = static_cast<int>(i);
+			}
+		});
+		for (std::size_t i = 0; i < values.size(); ++i)
+		{
+			CHECK(values[i] == static_cast<int>(i));
+		}
+		// The helper tasks queued behind the blockers find nothing left to do once they run
+		release.set_value();
+		for (std::future<void> & blocker : blockers)
+		{
+			blocker.get();
+		}
+	}
+}
+
+int main()
+{
+	testCoversEveryIndex();
+	testRethrows();
+	testBusyPool();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+#include "TweenSystem.hpp"
+#include "Check.hpp"
+
+namespace
+{
+	void testRecyclingAndStaleHandles()
+	{
+		oak::TweenSystem system;
+		std::uint32_t value = system.addValue(5.f);
+		CHECK(!system.isActive(oak::TweenHandle()));
+		oak::TweenHandle first = system.play(value, 0.f, 10.f, sf::seconds(1.f));
+		CHECK(system.isActive(first) && system.getValue(value) == 0.f && system.getActiveCount() == 1);
+		system.update(sf::seconds(.5f));
+		CHECK(std::fabs(system.getValue(value) - 5.f) < 1e-4f);
+		// Single tweens write their final value and are recycled once they reach their duration
+		system.update(sf::seconds(.75f));
+		CHECK(system.getValue(value) == 10.f && !system.isActive(first) && system.getActiveCount() == 0);
+		CHECK(!system.stop(first));
+		// The record is reused with a new generation, so the old handle cannot stop the new tween
+		oak::TweenHandle second = system.play(value, 10.f, 0.f, sf::seconds(1.f));
+		CHECK(second.index == first.index && second.generation != first.generation);
+		CHECK(!system.stop(first) && system.isActive(second));
+		CHECK(system.stop(second) && !system.isActive(second) && !system.stop(second));
+		// Stopping keeps whatever the tween wrote last
+		CHECK(system.getValue(value) == 10.f);
+	}
+
+	void testOneTweenPerValue()
+	{
+		// Playing on a value that is already tweened stops the previous tween, whatever its group
+		oak::TweenSystem system;
+		std::uint32_t value = system.addValue();
+		oak::TweenHandle first = system.play(value, 0.f, 10.f, sf::seconds(1.f), oak::TweenerStyle::Linear);
+		oak::TweenHandle second = system.play(value, 100.f, 200.f, sf::seconds(1.f), oak::TweenerStyle::Quadratic, oak::TweenerPeriod::WrapAround);
+		CHECK(!system.isActive(first) && system.isActive(second) && system.getActiveCount() == 1);
+		system.update(sf::seconds(.25f));
+		CHECK(system.getValue(value) >= 100.f && system.getValue(value) <= 200.f);
+		system.clear();
+		CHECK(system.getActiveCount() == 0 && !system.isActive(second));
+	}
+
+	void testRepeatingAndSwapRemove()
+	{
+		// Releasing a tween moves another into its place; every remaining tween must keep writing its own value
+		oak::TweenSystem system;
+		std::vector<std::uint32_t> values;
+		std::vector<oak::TweenHandle> handles;
+		for (int i = 0; i < 64; ++i)
+		{
+			values.push_back(system.addValue());
+			handles.push_back(system.play(values.back(), static_cast<float>(i), static_cast<float>(i) + 1.f, sf::seconds(1.f), oak::TweenerStyle::Linear, oak::TweenerPeriod::WrapAround));
+		}
+		for (int i = 0; i < 64; i += 3)
+		{
+			CHECK(system.stop(handles[i]));
+		}
+		system.update(sf::seconds(.25f));
+		for (int i = 0; i < 64; ++i)
+		{
+			if (i % 3)
+			{
+				CHECK(system.isActive(handles[i]));
+				CHECK(std::fabs(system.getValue(values[i]) - (static_cast<float>(i) + .25f)) < 1e-4f);
+			}
+			else
+			{
+				CHECK(!system.isActive(handles[i]) && system.getValue(values[i]) == static_cast<float>(i));
+			}
+		}
+		// Repeating tweens never finish on their own
+		system.update(sf::seconds(10.f));
+		CHECK(system.getActiveCount() == 64 - 22);
+	}
+
+	void testMatchesDiscreteTweener()
+	{
+		// Same curves as DiscreteTweener, within the easing tables' error
+		oak::TweenSystem system;
+		for (int style = 0; style < static_cast<int>(oak::TweenerStyle::Random); ++style)
+		{
+			for (int period = 0; period <= static_cast<int>(oak::TweenerPeriod::WrapAround); ++period)
+			{
+				float reference = 0.f;
+				oak::DiscreteTweener tweener(reference, 2.f, 10.f, sf::seconds(1.5f));
+				tweener.setStyle(static_cast<oak::TweenerStyle>(style));
+				tweener.setPeriod(static_cast<oak::TweenerPeriod>(period));
+				std::uint32_t value = system.addValue();
+				oak::TweenHandle handle = system.play(value, 2.f, 10.f, sf::seconds(1.5f), static_cast<oak::TweenerStyle>(style), static_cast<oak::TweenerPeriod>(period));
+				float worst = 0.f;
+				for (int step = 0; step < 2000; ++step)
+				{
+					tweener.update(sf::seconds(.00237f));
+					system.update(sf::seconds(.00237f));
+					worst = std::max(worst, std::fabs(reference - system.getValue(value)) / 8.f);
+				}
+				CHECK(worst < .03f);
+				system.stop(handle);
+			}
+		}
+	}
+
+	void testEasingTables()
+	{
+		for (const oak::EasingReport & entry : oak::reportEasingTables(1 << 12))
+		{
+			CHECK(entry.maximumError < .03f && entry.meanError <= entry.maximumError);
+		}
+	}
+
+	void benchmarkMillionTweens()
+	{
+		const std::size_t count = 1000000;
+		oak::TweenSystem system;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			std::uint32_t value = system.addValue();
+			system.play(value, 0.f, 1.f, sf::seconds(1.f + static_cast<float>(i % 7)), static_cast<oak::TweenerStyle>(1 + i % 2), oak::TweenerPeriod::WrapAround);
+		}
+		CHECK(system.getActiveCount() == count);
+		double batched = test::millisecondsPerRun(20, [&]
+		{
+			system.update(sf::seconds(.016f));
+		});
+		CHECK(system.getActiveCount() == count);
+		for (std::size_t i = 0; i < count; i += 9973)
+		{
+			CHECK(system.getValue(static_cast<std::uint32_t>(i)) >= 0.f && system.getValue(static_cast<std::uint32_t>(i)) <= 1.f);
+		}
+		std::vector<float> values(count);
+		std::vector<oak::DiscreteTweener> tweeners;
+		tweeners.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			tweeners.emplace_back(values[i], 0.f, 1.f, sf::seconds(1.f + static_cast<float>(i % 7)));
+			tweeners.back().setStyle(static_cast<oak::TweenerStyle>(1 + i % 2));
+			tweeners.back().setPeriod(oak::TweenerPeriod::WrapAround);
+		}
+		double discrete = test::millisecondsPerRun(20, [&]
+		{
+			for (oak::DiscreteTweener & tweener : tweeners)
+			{
+				tweener.update(sf::seconds(.016f));
+			}
+		});
+		std::printf("1M tweens: TweenSystem::update %.2f ms, DiscreteTweener::update loop %.2f ms\n", batched, discrete);
+	}
+}
+
+int main()
+{
+	testRecyclingAndStaleHandles();
+	testOneTweenPerValue();
+	testRepeatingAndSwapRemove();
+	testMatchesDiscreteTweener();
+	testEasingTables();
+	benchmarkMillionTweens();
+	return 0;
+}
\ No newline at end of file